@@ -0,0 +1,52 @@
+#include <Arduino.h>
+
+#include "AsyncATHandler.h"
+
+// Keeps every promise, response and stored line in a PSRAM arena instead of the internal heap.
+// The arena is rewound each time the modem is restarted.
+static const size_t kArenaSize = 64 * 1024;
+
+ATMonotonicArena* arena = nullptr;
+AsyncATHandler* handler = nullptr;
+
+void startModem() {
+  if (!handler->begin(Serial2)) {
+    Serial.println("Handler begin failed");
+    return;
+  }
+  handler->sendSync("ATE0", 1000);
+}
+
+void restartModem() {
+  handler->end();
+  Serial.printf(
+      "Arena used %u of %u bytes, %u overflows\n", arena->getUsedBytes(), arena->getCapacity(),
+      arena->getOverflowCount());
+  arena->reset();
+  startModem();
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial2.begin(115200);
+
+  void* buffer = ps_malloc(kArenaSize);
+  if (!buffer) { Serial.println("No PSRAM, falling back to the internal heap"); }
+  arena = new ATMonotonicArena(buffer, buffer ? kArenaSize : 0);
+  handler = new AsyncATHandler(arena);
+  startModem();
+}
+
+void loop() {
+  ATPromise* promise = handler->sendCommand("AT+CSQ");
+  int rssi = 0, ber = 0;
+  if (promise && promise->timeout(1000)->wait() &&
+      promise->getResponse()->scan("+CSQ:", rssi, ber) == 2) {
+    Serial.printf("RSSI %d\n", rssi);
+  }
+  if (promise) { handler->popCompletedPromise(promise->getId()); }
+
+  // Frees are no-ops inside the arena, so restart before it spills into the internal heap.
+  if (arena->getUsedBytes() > kArenaSize * 3 / 4) { restartModem(); }
+  delay(1000);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Longest cached command and invalidating URC prefix, including the terminating NUL. Longer
+// ones are refused by cacheCommand().
+#ifndef AT_CACHE_COMMAND_LENGTH
+#define AT_CACHE_COMMAND_LENGTH 24
+#endif
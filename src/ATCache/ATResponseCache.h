@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstring>
+
+#include "../ATResponse/ATResponse.h"
+#include "ATCache.settings.h"
+
+// Last successful response per registered query command, valid for the command's TTL. Not
+// thread-safe; AsyncATHandler guards it with its promise mutex.
+template <size_t Capacity>
+class ATResponseCache {
+ private:
+  struct Entry {
+    char command[AT_CACHE_COMMAND_LENGTH] = {};
+    char invalidatedBy[AT_CACHE_COMMAND_LENGTH] = {};
+    uint32_t ttlMs = 0;
+    unsigned long storedAt = 0;
+    bool valid = false;
+    ATResponse response{0};
+  };
+
+  Entry entries[Capacity];
+  size_t count = 0;
+
+  static bool fits(const char* text) { return strlen(text) < AT_CACHE_COMMAND_LENGTH; }
+
+  static void drop(Entry& entry) {
+    entry.valid = false;
+    entry.response = ATResponse(0);
+  }
+
+ public:
+  // Registers a command, or updates its TTL and URC prefix. False when the table is full or a
+  // string is too long.
+  bool add(const char* command, uint32_t ttlMs, const char* invalidatedBy) {
+    if (!command || !fits(command) || (invalidatedBy && !fits(invalidatedBy))) { return false; }
+    int slot = find(command);
+    if (slot < 0) {
+      if (count == Capacity) { return false; }
+      slot = static_cast<int>(count++);
+      strcpy(entries[slot].command, command);
+    }
+    Entry& entry = entries[slot];
+    entry.ttlMs = ttlMs;
+    strcpy(entry.invalidatedBy, invalidatedBy ? invalidatedBy : "");
+    drop(entry);
+    return true;
+  }
+
+  // Slot of a registered command, or -1.
+  int find(const char* command) const {
+    for (size_t i = 0; i < count; i++) {
+      if (strcmp(entries[i].command, command) == 0) { return static_cast<int>(i); }
+    }
+    return -1;
+  }
+
+  // The cached response if it is younger than the command's TTL, else nullptr.
+  const ATResponse* lookup(int slot, unsigned long nowMs) const {
+    const Entry& entry = entries[slot];
+    if (!entry.valid || nowMs - entry.storedAt >= entry.ttlMs) { return nullptr; }
+    return &entry.response;
+  }
+
+  void store(int slot, const ATResponse& response, unsigned long nowMs) {
+    Entry& entry = entries[slot];
+    entry.response = response;
+    entry.storedAt = nowMs;
+    entry.valid = true;
+  }
+
+  // Drops the entries whose invalidating prefix starts `line`.
+  void invalidateByURC(const char* line) {
+    for (size_t i = 0; i < count; i++) {
+      const char* prefix = entries[i].invalidatedBy;
+      if (entries[i].valid && *prefix && strncmp(line, prefix, strlen(prefix)) == 0) {
+        drop(entries[i]);
+      }
+    }
+  }
+
+  // Drops one command's entry, or all of them when command is null.
+  void invalidate(const char* command) {
+    for (size_t i = 0; i < count; i++) {
+      if (!command || strcmp(entries[i].command, command) == 0) { drop(entries[i]); }
+    }
+  }
+};
+
+// MaxCachedCommands = 0: the cache is compiled out.
+template <>
+class ATResponseCache<0> {
+ public:
+  bool add(const char*, uint32_t, const char*) { return false; }
+  int find(const char*) const { return -1; }
+  const ATResponse* lookup(int, unsigned long) const { return nullptr; }
+  void store(int, const ATResponse&, unsigned long) {}
+  void invalidateByURC(const char*) {}
+  void invalidate(const char*) {}
+};
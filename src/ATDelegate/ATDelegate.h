@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ATDelegate.settings.h"
+
+template <typename Signature, size_t Capacity = AT_DELEGATE_CAPACITY>
+class ATDelegate;
+
+// std::function replacement for library callbacks. The callable lives in Capacity bytes of inline
+// storage; there is no heap fallback, a larger capture is a compile error. Trivially copyable
+// callables (function pointers, lambdas capturing references or pointers) are copied with
+// memcpy, so assignment and calls cost one indirect call.
+template <typename R, typename... Args, size_t Capacity>
+class ATDelegate<R(Args...), Capacity> {
+ private:
+  enum class Operation { COPY, MOVE, DESTROY };
+
+  alignas(std::max_align_t) unsigned char storage[Capacity];
+  R (*invoker)(void* callable, Args... args) = nullptr;
+  // Null for trivially copyable callables.
+  void (*manager)(Operation operation, void* target, void* source) = nullptr;
+
+  template <typename F>
+  static R invoke(void* callable, Args... args) {
+    return (*static_cast<F*>(callable))(std::forward<Args>(args)...);
+  }
+
+  // A null function pointer makes an empty delegate instead of one that calls through null.
+  template <typename F>
+  static bool isNull(const F& callable, std::true_type) {
+    return callable == nullptr;
+  }
+  template <typename F>
+  static bool isNull(const F&, std::false_type) {
+    return false;
+  }
+
+  template <typename F>
+  static void manage(Operation operation, void* target, void* source) {
+    switch (operation) {
+      case Operation::COPY:
+        new (target) F(*static_cast<const F*>(source));
+        break;
+      case Operation::MOVE:
+        new (target) F(std::move(*static_cast<F*>(source)));
+        static_cast<F*>(source)->~F();
+        break;
+      case Operation::DESTROY:
+        static_cast<F*>(target)->~F();
+        break;
+    }
+  }
+
+  void copyFrom(const ATDelegate& other) {
+    invoker = other.invoker;
+    manager = other.manager;
+    if (manager) {
+      manager(Operation::COPY, storage, const_cast<unsigned char*>(other.storage));
+    } else if (invoker) {
+      memcpy(storage, other.storage, Capacity);
+    }
+  }
+
+  void moveFrom(ATDelegate& other) {
+    invoker = other.invoker;
+    manager = other.manager;
+    if (manager) {
+      manager(Operation::MOVE, storage, other.storage);
+    } else if (invoker) {
+      memcpy(storage, other.storage, Capacity);
+    }
+    other.invoker = nullptr;
+    other.manager = nullptr;
+  }
+
+ public:
+  ATDelegate() = default;
+  ATDelegate(std::nullptr_t) {}
+
+  template <
+      typename F, typename Callable = typename std::decay<F>::type,
+      typename = typename std::enable_if<!std::is_same<Callable, ATDelegate>::value>::type>
+  ATDelegate(F&& callable) {
+    static_assert(
+        sizeof(Callable) <= Capacity,
+        "Callback capture exceeds AT_DELEGATE_CAPACITY; capture a pointer instead");
+    static_assert(
+        alignof(Callable) <= alignof(std::max_align_t), "Callback capture is over-aligned");
+    if (isNull(callable, std::is_pointer<Callable>())) { return; }
+    new (storage) Callable(std::forward<F>(callable));
+    invoker = &invoke<Callable>;
+    if (!std::is_trivially_copyable<Callable>::value) { manager = &manage<Callable>; }
+  }
+
+  ATDelegate(const ATDelegate& other) { copyFrom(other); }
+  ATDelegate(ATDelegate&& other) noexcept { moveFrom(other); }
+  ~ATDelegate() { reset(); }
+
+  ATDelegate& operator=(const ATDelegate& other) {
+    if (this != &other) {
+      reset();
+      copyFrom(other);
+    }
+    return *this;
+  }
+  ATDelegate& operator=(ATDelegate&& other) noexcept {
+    if (this != &other) {
+      reset();
+      moveFrom(other);
+    }
+    return *this;
+  }
+  ATDelegate& operator=(std::nullptr_t) {
+    reset();
+    return *this;
+  }
+
+  void reset() {
+    if (manager) { manager(Operation::DESTROY, storage, nullptr); }
+    invoker = nullptr;
+    manager = nullptr;
+  }
+
+  // Calling an empty delegate is undefined; check it first.
+  R operator()(Args... args) const {
+    return invoker(const_cast<unsigned char*>(storage), std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const { return invoker != nullptr; }
+  bool operator==(std::nullptr_t) const { return invoker == nullptr; }
+  bool operator!=(std::nullptr_t) const { return invoker != nullptr; }
+};
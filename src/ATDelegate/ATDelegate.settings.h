@@ -0,0 +1,7 @@
+#pragma once
+
+// Bytes of inline storage per library callback (URC handler). A lambda capturing more than this
+// fails to compile; capture a pointer to a struct instead. Four pointers fit by default.
+#ifndef AT_DELEGATE_CAPACITY
+#define AT_DELEGATE_CAPACITY (4 * sizeof(void*))
+#endif
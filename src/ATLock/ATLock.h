@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "freertos/FreeRTOS.h"
+
+// Lock policies for BasicAsyncATHandler. A policy provides create(), destroy(), take(ticks),
+// give() and tests true once created.
+
+// FreeRTOS mutex with priority inheritance, statically allocated when the port allows it.
+class ATMutexLock {
+ private:
+  SemaphoreHandle_t handle = nullptr;
+#if configSUPPORT_STATIC_ALLOCATION
+  StaticSemaphore_t buffer;
+#endif
+
+ public:
+  ATMutexLock() = default;
+  ATMutexLock(const ATMutexLock&) = delete;
+  ATMutexLock& operator=(const ATMutexLock&) = delete;
+  ~ATMutexLock() { destroy(); }
+
+  bool create() {
+    if (handle) { return true; }
+#if configSUPPORT_STATIC_ALLOCATION
+    handle = xSemaphoreCreateMutexStatic(&buffer);
+#else
+    handle = xSemaphoreCreateMutex();
+#endif
+    return handle != nullptr;
+  }
+
+  void destroy() {
+    if (!handle) { return; }
+    SemaphoreHandle_t toDelete = handle;
+    handle = nullptr;
+    vSemaphoreDelete(toDelete);
+  }
+
+  bool take(TickType_t ticks) { return handle && xSemaphoreTake(handle, ticks) == pdTRUE; }
+  void give() {
+    if (handle) { xSemaphoreGive(handle); }
+  }
+
+  explicit operator bool() const { return handle != nullptr; }
+};
+
+// No locking at all. Only valid when a single task both sends and processes incoming data,
+// e.g. benchmarks driving the parser directly; the reader task started by begin() races with it.
+class ATNullLock {
+ private:
+  bool created = false;
+
+ public:
+  bool create() {
+    created = true;
+    return true;
+  }
+  void destroy() { created = false; }
+  bool take(TickType_t) { return created; }
+  void give() {}
+
+  explicit operator bool() const { return created; }
+};
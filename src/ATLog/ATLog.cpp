@@ -0,0 +1,61 @@
+#include "ATLog.h"
+
+ATDeferredLog& ATDeferredLog::instance() {
+  static ATDeferredLog log;
+  return log;
+}
+
+size_t ATDeferredLog::drain(Sink sink, void* context) {
+  if (!sink) { return 0; }
+  char message[160];
+  size_t delivered = 0;
+
+  while (true) {
+    uint32_t last = head.load(std::memory_order_acquire);
+    if (tail == last) { break; }
+    if (last - tail > AT_LOG_DEFERRED_CAPACITY) {
+      dropped += last - tail - AT_LOG_DEFERRED_CAPACITY;
+      tail = last - AT_LOG_DEFERRED_CAPACITY;
+    }
+
+    uint32_t sequence = tail + 1;
+    const Slot& slot = slots[tail & (AT_LOG_DEFERRED_CAPACITY - 1)];
+    uint32_t published = slot.sequence.load(std::memory_order_acquire);
+    if (published == 0 || published < sequence) { break; }  // Still being written
+    if (published != sequence) {
+      dropped++;
+      tail++;
+      continue;
+    }
+
+    ATLogRecord record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    tail++;
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      dropped++;
+      continue;
+    }
+
+    record.render(message, sizeof(message));
+    sink(record, message, context);
+    delivered++;
+  }
+  return delivered;
+}
+
+size_t ATDeferredLog::drain(Stream& out) {
+  return drain(
+      [](const ATLogRecord& record, const char* message, void* context) {
+        static const char kLevels[] = "NEWIDV";
+        char prefix[24];
+        int length = snprintf(
+            prefix, sizeof(prefix), "[%6lu][%c] ",
+            static_cast<unsigned long>(record.timestampUs / 1000),
+            kLevels[record.level < 6 ? record.level : 0]);
+        Stream* stream = static_cast<Stream*>(context);
+        stream->write(reinterpret_cast<const uint8_t*>(prefix), length);
+        stream->write(reinterpret_cast<const uint8_t*>(message), strlen(message));
+        stream->write(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+      },
+      &out);
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Stream.h>
+#include <esp_log.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "ATLog.settings.h"
+
+// Library logging. AT_LOGx(fmt, ...) compiles to nothing above AT_LOG_LEVEL, so arguments such
+// as response->getFullResponse() are never evaluated. With AT_LOG_DEFERRED the remaining calls
+// record into ATDeferredLog instead of formatting on the calling task.
+//
+// Deferred arguments must be numbers, pointers or C strings; strings are copied into the
+// record. The format must be a string literal, its address identifies the message.
+
+struct ATLogRecord {
+  const char* format;
+  uint32_t timestampUs;
+  uint8_t level;
+  int (*formatter)(const ATLogRecord& record, char* out, size_t size);
+  uint8_t payload[AT_LOG_DEFERRED_PAYLOAD];
+
+  // Formats the message like snprintf().
+  int render(char* out, size_t size) const { return formatter(*this, out, size); }
+};
+
+namespace ATLogDetail {
+
+template <typename T>
+struct Arg {
+  static_assert(
+      std::is_arithmetic<T>::value || std::is_pointer<T>::value,
+      "Deferred log arguments must be numbers, pointers or C strings");
+
+  using Stored = typename std::conditional<
+      std::is_floating_point<T>::value, double,
+      typename std::conditional<
+          std::is_integral<T>::value && sizeof(T) < sizeof(int), int, T>::type>::type;
+  static constexpr size_t kSize = sizeof(Stored);
+
+  static void store(uint8_t* payload, size_t& numeric, size_t&, T value) {
+    Stored stored = value;
+    memcpy(payload + numeric, &stored, kSize);
+    numeric += kSize;
+  }
+
+  static Stored load(const uint8_t* payload, size_t& numeric, size_t&) {
+    Stored value;
+    memcpy(&value, payload + numeric, kSize);
+    numeric += kSize;
+    return value;
+  }
+};
+
+// Strings are packed after all numeric arguments, truncated to the space left.
+template <>
+struct Arg<const char*> {
+  using Stored = const char*;
+  static constexpr size_t kSize = 0;
+
+  static void store(uint8_t* payload, size_t&, size_t& text, const char* value) {
+    if (text >= AT_LOG_DEFERRED_PAYLOAD) { return; }
+    size_t length = value ? strlen(value) : 0;
+    size_t room = AT_LOG_DEFERRED_PAYLOAD - text - 1;
+    if (length > room) { length = room; }
+    if (length) { memcpy(payload + text, value, length); }
+    payload[text + length] = '\0';
+    text += length + 1;
+  }
+
+  static Stored load(const uint8_t* payload, size_t&, size_t& text) {
+    if (text >= AT_LOG_DEFERRED_PAYLOAD) { return ""; }
+    const char* value = reinterpret_cast<const char*>(payload + text);
+    text += strlen(value) + 1;
+    return value;
+  }
+};
+
+template <>
+struct Arg<char*> : Arg<const char*> {};
+
+template <typename... Args>
+constexpr size_t numericSize() {
+  return (Arg<Args>::kSize + ... + 0);
+}
+
+template <typename... Args>
+int render(const ATLogRecord& record, char* out, size_t size) {
+  size_t numeric = 0;
+  size_t text = numericSize<Args...>();
+  // Braced initialization evaluates the loads left to right.
+  std::tuple<typename Arg<Args>::Stored...> values{
+      Arg<Args>::load(record.payload, numeric, text)...};
+  (void)numeric;
+  (void)text;
+  return std::apply(
+      [&](auto... value) { return snprintf(out, size, record.format, value...); }, values);
+}
+
+}  // namespace ATLogDetail
+
+// Multi-producer ring of unformatted log records, drained by a single consumer. Producers
+// never block: when the consumer falls behind, the oldest records are dropped and counted.
+class ATDeferredLog {
+ public:
+  typedef void (*Sink)(const ATLogRecord& record, const char* message, void* context);
+
+ private:
+  struct Slot {
+    std::atomic<uint32_t> sequence{0};
+    ATLogRecord record;
+  };
+
+  Slot slots[AT_LOG_DEFERRED_CAPACITY];
+  std::atomic<uint32_t> head{0};
+  uint32_t tail = 0;
+  uint32_t dropped = 0;
+
+ public:
+  static ATDeferredLog& instance();
+
+  template <typename... Args>
+  void record(uint8_t level, const char* format, Args... args) {
+    static_assert(
+        ATLogDetail::numericSize<Args...>() <= AT_LOG_DEFERRED_PAYLOAD,
+        "Log arguments exceed AT_LOG_DEFERRED_PAYLOAD");
+
+    uint32_t sequence = head.fetch_add(1, std::memory_order_relaxed) + 1;
+    Slot& slot = slots[(sequence - 1) & (AT_LOG_DEFERRED_CAPACITY - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ATLogRecord& entry = slot.record;
+    entry.format = format;
+    entry.timestampUs = micros();
+    entry.level = level;
+    entry.formatter = &ATLogDetail::render<Args...>;
+    size_t numeric = 0;
+    size_t text = ATLogDetail::numericSize<Args...>();
+    (ATLogDetail::Arg<Args>::store(entry.payload, numeric, text, args), ...);
+    (void)numeric;
+    (void)text;
+
+    slot.sequence.store(sequence, std::memory_order_release);
+  }
+
+  // Formats and hands pending records to `sink`, oldest first. Call from one task only, e.g. a
+  // low-priority logger task or loop(). Returns the number of records delivered.
+  size_t drain(Sink sink, void* context = nullptr);
+
+  // Writes pending records as "[<ms>][<level>] message" lines.
+  size_t drain(Stream& out);
+
+  uint32_t droppedCount() const { return dropped; }
+};
+
+#if AT_LOG_DEFERRED
+#define AT_LOG_EMIT(level, logger, fmt, ...) \
+  ATDeferredLog::instance().record(level, "" fmt, ##__VA_ARGS__)
+#else
+#define AT_LOG_EMIT(level, logger, fmt, ...) logger(fmt, ##__VA_ARGS__)
+#endif
+
+#define AT_LOG_AT(level, logger, fmt, ...)                                           \
+  do {                                                                              \
+    if ((level) <= AT_LOG_LEVEL) { AT_LOG_EMIT(level, logger, fmt, ##__VA_ARGS__); } \
+  } while (0)
+
+#define AT_LOGE(fmt, ...) AT_LOG_AT(1, log_e, fmt, ##__VA_ARGS__)
+#define AT_LOGW(fmt, ...) AT_LOG_AT(2, log_w, fmt, ##__VA_ARGS__)
+#define AT_LOGI(fmt, ...) AT_LOG_AT(3, log_i, fmt, ##__VA_ARGS__)
+#define AT_LOGD(fmt, ...) AT_LOG_AT(4, log_d, fmt, ##__VA_ARGS__)
+#define AT_LOGV(fmt, ...) AT_LOG_AT(5, log_v, fmt, ##__VA_ARGS__)
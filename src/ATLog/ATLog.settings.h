@@ -0,0 +1,35 @@
+#pragma once
+
+// Highest level the library logs at (1 error, 2 warn, 3 info, 4 debug, 5 verbose). Calls above
+// it are removed at compile time and their arguments are never evaluated. Defaults to the
+// native build's LOG_LEVEL, or the Arduino core's CORE_DEBUG_LEVEL.
+#ifndef AT_LOG_LEVEL
+#if defined(LOG_LEVEL)
+#define AT_LOG_LEVEL LOG_LEVEL
+#elif defined(CORE_DEBUG_LEVEL)
+#define AT_LOG_LEVEL CORE_DEBUG_LEVEL
+#else
+#define AT_LOG_LEVEL 1
+#endif
+#endif
+
+// Routes AT_LOGx through ATDeferredLog: the hot path stores the format string address and raw
+// arguments, formatting happens later in ATDeferredLog::drain().
+#ifndef AT_LOG_DEFERRED
+#define AT_LOG_DEFERRED 0
+#endif
+
+// Records kept until drained, must be a power of two. Older records are dropped.
+#ifndef AT_LOG_DEFERRED_CAPACITY
+#define AT_LOG_DEFERRED_CAPACITY 32
+#endif
+
+// Bytes per record for arguments. Numbers take their promoted size, strings are copied and
+// truncated to what is left.
+#ifndef AT_LOG_DEFERRED_PAYLOAD
+#define AT_LOG_DEFERRED_PAYLOAD 64
+#endif
+
+static_assert(
+    (AT_LOG_DEFERRED_CAPACITY & (AT_LOG_DEFERRED_CAPACITY - 1)) == 0,
+    "AT_LOG_DEFERRED_CAPACITY must be a power of two");
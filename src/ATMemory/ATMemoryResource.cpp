@@ -0,0 +1,18 @@
+#include "ATMemoryResource.h"
+
+#include <new>
+
+namespace {
+
+class ATNewDeleteResource : public ATMemoryResource {
+ protected:
+  void* doAllocate(size_t bytes, size_t) override { return ::operator new(bytes); }
+  void doDeallocate(void* pointer, size_t, size_t) override { ::operator delete(pointer); }
+};
+
+}  // namespace
+
+ATMemoryResource* ATMemoryResource::defaultResource() {
+  static ATNewDeleteResource resource;
+  return &resource;
+}
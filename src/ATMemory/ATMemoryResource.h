@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+
+// Allocation hook for promises, responses, expectation lists and stored line text, shaped after
+// std::pmr::memory_resource (which not every ESP32 toolchain ships). The reader task and the
+// tasks sending commands allocate concurrently, so implementations must be thread-safe.
+// allocate() must not return nullptr.
+class ATMemoryResource {
+ public:
+  virtual ~ATMemoryResource() = default;
+
+  void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    return doAllocate(bytes, alignment);
+  }
+  void deallocate(void* pointer, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    doDeallocate(pointer, bytes, alignment);
+  }
+
+  // operator new/delete; used when the handler is given no resource.
+  static ATMemoryResource* defaultResource();
+
+ protected:
+  virtual void* doAllocate(size_t bytes, size_t alignment) = 0;
+  virtual void doDeallocate(void* pointer, size_t bytes, size_t alignment) = 0;
+};
+
+// Standard allocator over an ATMemoryResource, for the library's std containers.
+template <typename T>
+class ATAllocator {
+  template <typename>
+  friend class ATAllocator;
+
+ private:
+  ATMemoryResource* resource;
+
+ public:
+  using value_type = T;
+
+  ATAllocator(ATMemoryResource* r = ATMemoryResource::defaultResource()) : resource(r) {}
+  template <typename U>
+  ATAllocator(const ATAllocator<U>& other) : resource(other.resource) {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* pointer, size_t count) {
+    resource->deallocate(pointer, count * sizeof(T), alignof(T));
+  }
+
+  ATMemoryResource* getResource() const { return resource; }
+
+  template <typename U>
+  bool operator==(const ATAllocator<U>& other) const {
+    return resource == other.resource;
+  }
+  template <typename U>
+  bool operator!=(const ATAllocator<U>& other) const {
+    return resource != other.resource;
+  }
+};
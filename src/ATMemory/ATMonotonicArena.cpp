@@ -0,0 +1,35 @@
+#include "ATMonotonicArena.h"
+
+#include <cstdint>
+
+ATMonotonicArena::ATMonotonicArena(void* buf, size_t size, ATMemoryResource* up)
+    : buffer(static_cast<unsigned char*>(buf)), capacity(buf ? size : 0), upstream(up) {}
+
+bool ATMonotonicArena::owns(const void* pointer) const {
+  const unsigned char* p = static_cast<const unsigned char*>(pointer);
+  return buffer && p >= buffer && p < buffer + capacity;
+}
+
+void* ATMonotonicArena::doAllocate(size_t bytes, size_t alignment) {
+  uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+  size_t current = offset.load(std::memory_order_relaxed);
+  while (buffer) {
+    uintptr_t aligned = (base + current + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    size_t next = static_cast<size_t>(aligned - base) + bytes;
+    if (next > capacity) { break; }
+    if (offset.compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+      return reinterpret_cast<void*>(aligned);
+    }
+  }
+  overflowCount.fetch_add(1, std::memory_order_relaxed);
+  return upstream->allocate(bytes, alignment);
+}
+
+void ATMonotonicArena::doDeallocate(void* pointer, size_t bytes, size_t alignment) {
+  if (!owns(pointer)) { upstream->deallocate(pointer, bytes, alignment); }
+}
+
+void ATMonotonicArena::reset() {
+  offset.store(0, std::memory_order_relaxed);
+  overflowCount.store(0, std::memory_order_relaxed);
+}
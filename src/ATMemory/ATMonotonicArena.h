@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "ATMemoryResource.h"
+
+// Bump allocator over a caller-owned buffer, e.g. a block of PSRAM. Freeing memory from the
+// buffer is a no-op; it is reclaimed all at once by reset(). Requests that no longer fit go to
+// the upstream resource. allocate() is lock-free, so the reader and sending tasks can share it.
+class ATMonotonicArena : public ATMemoryResource {
+ private:
+  unsigned char* buffer;
+  size_t capacity;
+  ATMemoryResource* upstream;
+  std::atomic<size_t> offset{0};
+  std::atomic<size_t> overflowCount{0};
+
+  bool owns(const void* pointer) const;
+
+ protected:
+  void* doAllocate(size_t bytes, size_t alignment) override;
+  void doDeallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+ public:
+  ATMonotonicArena(
+      void* buffer, size_t size, ATMemoryResource* upstream = ATMemoryResource::defaultResource());
+  ATMonotonicArena(const ATMonotonicArena&) = delete;
+  ATMonotonicArena& operator=(const ATMonotonicArena&) = delete;
+
+  // Rewinds to the start of the buffer. Only valid once nothing allocated from it is in use,
+  // e.g. after AsyncATHandler::end().
+  void reset();
+
+  size_t getUsedBytes() const { return offset.load(std::memory_order_relaxed); }
+  size_t getCapacity() const { return capacity; }
+  // Allocations handed to the upstream resource because the buffer was full.
+  size_t getOverflowCount() const { return overflowCount.load(std::memory_order_relaxed); }
+};
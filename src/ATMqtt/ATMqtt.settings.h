@@ -0,0 +1,13 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Topic handlers one ATMqttReceiver holds.
+#ifndef AT_MQTT_MAX_SUBSCRIPTIONS
+#define AT_MQTT_MAX_SUBSCRIPTIONS 8
+#endif
+
+// Longest topic prefix subscribe() accepts, stored inline.
+#ifndef AT_MQTT_PREFIX_LENGTH
+#define AT_MQTT_PREFIX_LENGTH 48
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstring>
+#include <string_view>
+
+// A `+QMTRECV:` message as views into the received line, e.g.
+//
+//   +QMTRECV: 0,1,"cfg/led",6,"ab\r\ncd"   payload length reported (AT+QMTCFG="recv/mode",0,0,1)
+//   +QMTRECV: 0,1,"cfg/led","on"           payload up to the last quote of the line
+//
+// Only the first form delimits payloads containing quotes followed by a line end reliably. The
+// views are valid as long as the line is.
+struct ATMqttMessage {
+  static constexpr const char* kPrefix = "+QMTRECV:";
+
+  uint8_t clientId = 0;
+  uint16_t msgId = 0;
+  std::string_view topic;
+  std::string_view payload;
+
+  // Decodes a complete line including its "\r\n". Returns false for other lines and for the
+  // buffer mode notice `+QMTRECV: <client>,<recv_id>`, which carries no message.
+  static bool parse(const char* line, size_t length, ATMqttMessage& out) {
+    return scan(line, length, out) == Scan::MESSAGE;
+  }
+
+  // False while `line`, ending in "\r\n", is a `+QMTRECV:` message whose payload continues on
+  // the next line. The handler keeps reading into the same buffer until this turns true.
+  static bool isComplete(const char* line, size_t length) {
+    ATMqttMessage ignored;
+    return scan(line, length, ignored) != Scan::INCOMPLETE;
+  }
+
+  // Bytes the message spans, its final "\r\n" included, when the header reports the payload
+  // length, 0 otherwise. `line` ends in "\r\n" and holds at least the header.
+  static size_t frameLength(const char* line, size_t length) {
+    ATMqttMessage ignored;
+    size_t bytes = 0;
+    scan(line, length, ignored, &bytes);
+    return bytes;
+  }
+
+ private:
+  enum class Scan : uint8_t { MALFORMED, NOTICE, INCOMPLETE, MESSAGE };
+
+  static bool number(const char*& p, const char* end, uint32_t& value) {
+    const char* digits = p;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9' && p - digits < 9) {
+      value = value * 10 + (*p++ - '0');
+    }
+    return p != digits;
+  }
+
+  static bool skip(const char*& p, const char* end, char c) {
+    while (p < end && *p == ' ') { p++; }
+    if (p == end || *p != c) { return false; }
+    p++;
+    return true;
+  }
+
+  static Scan scan(
+      const char* line, size_t length, ATMqttMessage& out, size_t* frameLength = nullptr) {
+    size_t prefixLength = strlen(kPrefix);
+    if (length < prefixLength + 2 || memcmp(line, kPrefix, prefixLength) != 0 ||
+        memcmp(line + length - 2, "\r\n", 2) != 0) {
+      return Scan::MALFORMED;
+    }
+    const char* p = line + prefixLength;
+    const char* end = line + length - 2;  // Without the final "\r\n"
+
+    uint32_t clientId = 0, msgId = 0;
+    while (p < end && *p == ' ') { p++; }
+    if (!number(p, end, clientId) || !skip(p, end, ',') || !number(p, end, msgId)) {
+      return Scan::MALFORMED;
+    }
+    if (p == end) { return Scan::NOTICE; }
+    if (!skip(p, end, ',') || !skip(p, end, '"')) { return Scan::MALFORMED; }
+    const char* topic = p;
+    while (p < end && *p != '"') { p++; }
+    if (p == end) { return Scan::MALFORMED; }
+    out.topic = std::string_view(topic, p - topic);
+    p++;
+    if (!skip(p, end, ',')) { return Scan::MALFORMED; }
+    while (p < end && *p == ' ') { p++; }
+
+    if (p < end && *p != '"') {
+      uint32_t payloadLength = 0;
+      if (!number(p, end, payloadLength) || !skip(p, end, ',') || !skip(p, end, '"')) {
+        return Scan::MALFORMED;
+      }
+      if (frameLength) { *frameLength = (p - line) + payloadLength + 3; }  // Quote and "\r\n"
+      // The payload plus its closing quote may run past line ends the modem does not escape.
+      if (static_cast<size_t>(end - p) < payloadLength + 1) { return Scan::INCOMPLETE; }
+      if (p[payloadLength] != '"' || p + payloadLength + 1 != end) { return Scan::MALFORMED; }
+      out.payload = std::string_view(p, payloadLength);
+    } else {
+      if (!skip(p, end, '"')) { return Scan::MALFORMED; }
+      if (p == end || end[-1] != '"') { return Scan::INCOMPLETE; }
+      out.payload = std::string_view(p, end - 1 - p);
+    }
+    out.clientId = static_cast<uint8_t>(clientId);
+    out.msgId = static_cast<uint16_t>(msgId);
+    return Scan::MESSAGE;
+  }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <cstring>
+
+#include "../ATLock/ATLock.h"
+#include "../AsyncATHandler.h"
+#include "ATMqtt.settings.h"
+#include "ATMqttMessage.h"
+
+typedef ATDelegate<void(const ATMqttMessage& message)> ATMqttCallback;
+
+// Dispatches `+QMTRECV:` messages to handlers by topic prefix. The message is decoded in place
+// in the handler's line buffer, so neither topic nor payload is copied on the way:
+//
+//   ATMqttReceiver mqtt(handler);
+//   mqtt.begin();
+//   mqtt.subscribe("cfg/", [](const ATMqttMessage& message) { apply(message.payload); });
+//
+// Every handler whose prefix matches is called. Handlers run on the reader task with the
+// handler's promise list locked; the views are only valid during the call, and handlers must
+// not call into the handler or the receiver.
+template <typename HandlerConfig = DefaultATHandlerConfig>
+class BasicATMqttReceiver {
+ public:
+  using Handler = BasicAsyncATHandler<HandlerConfig>;
+
+ private:
+  struct Subscription {
+    char prefix[AT_MQTT_PREFIX_LENGTH + 1];
+    size_t prefixLength = 0;
+    ATMqttCallback callback;
+  };
+
+  Handler& handler;
+  ATMutexLock lock;  // Guards subscriptions against the reader task
+  int listenerId = -1;
+  Subscription subscriptions[AT_MQTT_MAX_SUBSCRIPTIONS];
+
+  std::atomic<uint32_t> messagesDispatched{0};
+  std::atomic<uint32_t> messagesUnmatched{0};
+
+  void handleURC(const char* line, size_t length) {
+    ATMqttMessage message;
+    if (!ATMqttMessage::parse(line, length, message) || !lock.take(portMAX_DELAY)) { return; }
+    bool matched = false;
+    for (auto& subscription : subscriptions) {
+      if (!subscription.callback || message.topic.size() < subscription.prefixLength ||
+          memcmp(message.topic.data(), subscription.prefix, subscription.prefixLength) != 0) {
+        continue;
+      }
+      subscription.callback(message);
+      matched = true;
+    }
+    lock.give();
+    (matched ? messagesDispatched : messagesUnmatched).fetch_add(1, std::memory_order_relaxed);
+  }
+
+ public:
+  explicit BasicATMqttReceiver(Handler& atHandler) : handler(atHandler) {}
+  ~BasicATMqttReceiver() { end(); }
+  BasicATMqttReceiver(const BasicATMqttReceiver&) = delete;
+  BasicATMqttReceiver& operator=(const BasicATMqttReceiver&) = delete;
+
+  // Registers the URC listener. The handler must be running.
+  bool begin() {
+    if (listenerId >= 0 || !lock.create()) { return false; }
+    listenerId = handler.addURCListener(
+        URCListener([this](const char* line, size_t length) { handleURC(line, length); }));
+    if (listenerId < 0) {
+      lock.destroy();
+      return false;
+    }
+    return true;
+  }
+
+  // Stops dispatching and forgets all handlers.
+  void end() {
+    if (listenerId < 0) { return; }
+    handler.removeURCListener(listenerId);
+    listenerId = -1;
+    for (auto& subscription : subscriptions) { subscription.callback = nullptr; }
+    lock.destroy();
+  }
+
+  // Calls callback for messages whose topic starts with topicPrefix ("" for all). Returns an id
+  // for unsubscribe(), or -1 when the prefix is too long, all AT_MQTT_MAX_SUBSCRIPTIONS are in
+  // use or begin() was not called.
+  int subscribe(const char* topicPrefix, const ATMqttCallback& callback) {
+    size_t prefixLength = topicPrefix ? strlen(topicPrefix) : 0;
+    if (!topicPrefix || !callback || prefixLength > AT_MQTT_PREFIX_LENGTH || listenerId < 0 ||
+        !lock.take(portMAX_DELAY)) {
+      return -1;
+    }
+    int id = -1;
+    for (size_t i = 0; i < AT_MQTT_MAX_SUBSCRIPTIONS; i++) {
+      Subscription& subscription = subscriptions[i];
+      if (subscription.callback) { continue; }
+      memcpy(subscription.prefix, topicPrefix, prefixLength + 1);
+      subscription.prefixLength = prefixLength;
+      subscription.callback = callback;
+      id = static_cast<int>(i);
+      break;
+    }
+    lock.give();
+    return id;
+  }
+
+  // Waits for a dispatch in progress to finish, then drops the handler.
+  void unsubscribe(int id) {
+    if (id < 0 || id >= AT_MQTT_MAX_SUBSCRIPTIONS || listenerId < 0 ||
+        !lock.take(portMAX_DELAY)) {
+      return;
+    }
+    subscriptions[id].callback = nullptr;
+    lock.give();
+  }
+
+  // Messages that reached at least one handler, and those no prefix matched.
+  uint32_t getMessagesDispatched() const {
+    return messagesDispatched.load(std::memory_order_relaxed);
+  }
+  uint32_t getMessagesUnmatched() const {
+    return messagesUnmatched.load(std::memory_order_relaxed);
+  }
+};
+
+using ATMqttReceiver = BasicATMqttReceiver<>;
@@ -0,0 +1,191 @@
+#include "ATMux.h"
+
+#include <algorithm>
+
+#include "../ATLog/ATLog.h"
+
+size_t ATMuxChannel::write(const uint8_t* buffer, size_t size) {
+  if (!mux || !isOpen()) { return 0; }
+  size_t written = 0;
+  while (written < size) {
+    size_t chunk = std::min<size_t>(size - written, AT_MUX_FRAME_SIZE);
+    if (!mux->sendFrame(dlci, ATMuxFrame::kUIH, true, buffer + written, chunk)) { break; }
+    written += chunk;
+  }
+  return written;
+}
+
+ATMux::ATMux() {
+  for (size_t i = 0; i < AT_MUX_MAX_CHANNELS; i++) {
+    channels[i].mux = this;
+    channels[i].dlci = static_cast<uint8_t>(i + 1);
+  }
+}
+
+ATMux::~ATMux() {
+  end();
+  if (replied) { vSemaphoreDelete(replied); }
+}
+
+bool ATMux::begin(Stream& physical, size_t count, const ATMuxConfig& cfg) {
+  if (task || count == 0 || count > AT_MUX_MAX_CHANNELS) { return false; }
+  stream = &physical;
+  config = cfg;
+  decoder.reset();
+  if (!replied) {
+#if configSUPPORT_STATIC_ALLOCATION
+    replied = xSemaphoreCreateBinaryStatic(&repliedBuffer);
+#else
+    replied = xSemaphoreCreateBinary();
+#endif
+  }
+  if (!replied || !writeLock.create()) {
+    stream = nullptr;
+    return false;
+  }
+
+  if (xTaskCreatePinnedToCore(
+          taskFunction, config.taskName, config.stackSize, this, config.priority, &task,
+          config.coreId) != pdPASS) {
+    task = nullptr;
+    writeLock.destroy();
+    stream = nullptr;
+    return false;
+  }
+
+  for (size_t dlci = 0; dlci <= count; dlci++) {
+    if (!establish(static_cast<uint8_t>(dlci))) {
+      AT_LOGE("CMUX channel %u was not opened", static_cast<unsigned>(dlci));
+      end();
+      return false;
+    }
+    if (dlci) { channels[dlci - 1].open.store(true, std::memory_order_release); }
+  }
+  channelCount = count;
+  return true;
+}
+
+void ATMux::end() {
+  if (!task) { return; }
+  if (channelCount) {
+    const uint8_t closeDown[] = {ATMuxFrame::kCLD | ATMuxFrame::kCR, ATMuxFrame::kEA};
+    sendFrame(0, ATMuxFrame::kUIH, true, closeDown, sizeof(closeDown));
+  }
+  for (auto& channel : channels) { channel.open.store(false, std::memory_order_release); }
+
+  // Holding the write lock keeps the task from being deleted halfway through a reply.
+  bool locked = writeLock.take(pdMS_TO_TICKS(100));
+  TaskHandle_t taskToDelete = task;
+  task = nullptr;
+  vTaskDelete(taskToDelete);
+  if (locked) { writeLock.give(); }
+
+  writeLock.destroy();
+  for (auto& channel : channels) {
+    channel.rx.clear();
+    channel.droppedBytes.store(0, std::memory_order_relaxed);
+  }
+  channelCount = 0;
+  stream = nullptr;
+}
+
+bool ATMux::establish(uint8_t dlci) {
+  xSemaphoreTake(replied, 0);
+  reply.store(0, std::memory_order_relaxed);
+  awaitedDlci.store(dlci, std::memory_order_release);
+  bool sent = sendFrame(dlci, ATMuxFrame::kSABM | ATMuxFrame::kPF, true, nullptr, 0);
+  bool answered = sent && xSemaphoreTake(replied, pdMS_TO_TICKS(config.openTimeoutMs)) == pdTRUE;
+  awaitedDlci.store(-1, std::memory_order_release);
+  return answered && reply.load(std::memory_order_acquire) == ATMuxFrame::kUA;
+}
+
+bool ATMux::sendFrame(
+    uint8_t dlci, uint8_t control, bool command, const uint8_t* data, size_t length) {
+  uint8_t frame[ATMuxFrame::kMaxFrame];
+  size_t size = ATMuxFrame::encode(frame, dlci, control, command, data, length);
+  if (!writeLock.take(pdMS_TO_TICKS(100))) {
+    AT_LOGE("Failed to acquire CMUX write lock");
+    return false;
+  }
+  Stream* out = stream;
+  if (out) {
+    out->write(frame, size);
+    out->flush();
+  }
+  writeLock.give();
+  return out != nullptr;
+}
+
+void ATMux::taskFunction(void* parameter) {
+  auto* mux = static_cast<ATMux*>(parameter);
+  const TickType_t interval = std::max<TickType_t>(1, pdMS_TO_TICKS(mux->config.pollIntervalMs));
+  while (true) {
+    mux->processIncoming();
+    vTaskDelay(interval);
+  }
+}
+
+void ATMux::processIncoming() {
+  while (stream && stream->available() > 0) {
+    int c = stream->read();
+    if (c < 0) { break; }
+    switch (decoder.feed(static_cast<uint8_t>(c))) {
+      case ATMuxDecoder::Result::FRAME:
+        handleFrame();
+        break;
+      case ATMuxDecoder::Result::ERROR:
+        frameErrors.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case ATMuxDecoder::Result::NONE:
+        break;
+    }
+  }
+}
+
+void ATMux::handleFrame() {
+  uint8_t dlci = decoder.dlci();
+  uint8_t control = decoder.control();
+  ATMuxChannel* channel =
+      dlci >= 1 && dlci <= AT_MUX_MAX_CHANNELS ? &channels[dlci - 1] : nullptr;
+
+  switch (control) {
+    case ATMuxFrame::kUIH:
+      if (dlci == 0) {
+        handleControlMessage(decoder.data(), decoder.length());
+      } else if (channel && channel->isOpen()) {
+        size_t stored = channel->rx.write(decoder.data(), decoder.length());
+        if (stored < decoder.length()) {
+          channel->droppedBytes.fetch_add(decoder.length() - stored, std::memory_order_relaxed);
+        }
+      }
+      break;
+    case ATMuxFrame::kUA:
+    case ATMuxFrame::kDM:
+      if (awaitedDlci.load(std::memory_order_acquire) == dlci) {
+        reply.store(control, std::memory_order_release);
+        xSemaphoreGive(replied);
+      } else if (control == ATMuxFrame::kDM && channel) {
+        channel->open.store(false, std::memory_order_release);
+      }
+      break;
+    case ATMuxFrame::kDISC:
+      if (channel) { channel->open.store(false, std::memory_order_release); }
+      sendFrame(dlci, ATMuxFrame::kUA | ATMuxFrame::kPF, false, nullptr, 0);
+      break;
+    case ATMuxFrame::kSABM:
+      // Channels are only opened from this side.
+      sendFrame(dlci, ATMuxFrame::kDM | ATMuxFrame::kPF, false, nullptr, 0);
+      break;
+    default:
+      break;
+  }
+}
+
+// Modem status and other commands from the modem are acknowledged by echoing them as responses.
+void ATMux::handleControlMessage(const uint8_t* data, size_t length) {
+  if (length == 0 || !(data[0] & ATMuxFrame::kCR)) { return; }
+  uint8_t response[AT_MUX_FRAME_SIZE];
+  memcpy(response, data, length);
+  response[0] &= ~ATMuxFrame::kCR;
+  sendFrame(0, ATMuxFrame::kUIH, false, response, length);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "../ATLock/ATLock.h"
+#include "../ATRingBuffer/ATRingBuffer.h"
+#include "ATMux.settings.h"
+#include "ATMuxFrame.h"
+#include "freertos/FreeRTOS.h"
+
+class ATMux;
+
+// One virtual channel of an ATMux, to be passed to AsyncATHandler::begin() like a UART. Reads
+// come from a buffer the mux task fills; each write() is sent as UIH frames of at most
+// AT_MUX_FRAME_SIZE bytes. One task may read and any number may write.
+class ATMuxChannel : public Stream {
+ private:
+  friend class ATMux;
+
+  ATMux* mux = nullptr;
+  uint8_t dlci = 0;
+  ATRingBuffer<AT_MUX_RX_BUFFER> rx;
+  std::atomic<bool> open{false};
+  std::atomic<uint32_t> droppedBytes{0};
+
+ public:
+  ATMuxChannel() = default;
+  ATMuxChannel(const ATMuxChannel&) = delete;
+  ATMuxChannel& operator=(const ATMuxChannel&) = delete;
+
+  int available() override { return static_cast<int>(rx.available()); }
+  int read() override { return rx.pop(); }
+  int peek() override { return rx.peek(); }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  // Returns 0 while the channel is closed.
+  size_t write(const uint8_t* buffer, size_t size) override;
+  // Frames are handed to the physical stream, and flushed, as they are written.
+  void flush() override {}
+
+  bool isOpen() const { return open.load(std::memory_order_acquire); }
+  uint8_t getDlci() const { return dlci; }
+  // Bytes discarded because the receive buffer was full.
+  uint32_t getDroppedBytes() const { return droppedBytes.load(std::memory_order_relaxed); }
+};
+
+// 3GPP TS 27.010 multiplexer (basic option) on a single stream. Switch the modem to CMUX mode
+// first, e.g. with AT+CMUX=0 through a handler on the UART, then end() that handler and run one
+// handler per channel:
+//
+//   ATMux mux;
+//   mux.begin(Serial2, 2);
+//   control.begin(mux.channel(1));
+//   data.begin(mux.channel(2));
+class ATMux {
+ private:
+  friend class ATMuxChannel;
+
+  Stream* stream = nullptr;
+  ATMuxConfig config;
+  TaskHandle_t task = nullptr;
+  ATMutexLock writeLock;  // Keeps frames from different channels whole on the wire
+  ATMuxDecoder decoder;
+  ATMuxChannel channels[AT_MUX_MAX_CHANNELS];
+  size_t channelCount = 0;
+
+  // Answer to the SABM begin() is waiting for.
+  SemaphoreHandle_t replied = nullptr;
+#if configSUPPORT_STATIC_ALLOCATION
+  StaticSemaphore_t repliedBuffer;
+#endif
+  std::atomic<int> awaitedDlci{-1};
+  std::atomic<uint8_t> reply{0};
+
+  std::atomic<uint32_t> frameErrors{0};
+
+  static void taskFunction(void* parameter);
+  void processIncoming();
+  void handleFrame();
+  void handleControlMessage(const uint8_t* data, size_t length);
+  bool establish(uint8_t dlci);
+  bool sendFrame(uint8_t dlci, uint8_t control, bool command, const uint8_t* data, size_t length);
+
+ public:
+  ATMux();
+  ~ATMux();
+  ATMux(const ATMux&) = delete;
+  ATMux& operator=(const ATMux&) = delete;
+
+  // Opens the control channel and DLCIs 1..channels on a stream already in CMUX mode. Fails if
+  // the modem refuses one or does not answer within config.openTimeoutMs.
+  bool begin(
+      Stream& physical, size_t channels = AT_MUX_MAX_CHANNELS,
+      const ATMuxConfig& config = ATMuxConfig());
+  // Sends the close-down command, which returns the modem to AT mode, and stops the mux task.
+  // End the channels' handlers first.
+  void end();
+
+  // DLCI 1..AT_MUX_MAX_CHANNELS.
+  ATMuxChannel& channel(uint8_t dlci) { return channels[dlci - 1]; }
+  size_t getChannelCount() const { return channelCount; }
+  // Frames dropped for a bad FCS, framing or size.
+  uint32_t getFrameErrors() const { return frameErrors.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "freertos/FreeRTOS.h"
+
+// Virtual channels (DLCIs 1..n) an ATMux can open besides the control channel.
+#ifndef AT_MUX_MAX_CHANNELS
+#define AT_MUX_MAX_CHANNELS 3
+#endif
+
+// Largest information field per frame (N1). Must not be below the modem's, e.g. the fourth
+// parameter of AT+CMUX=0,0,5,127. Longer incoming frames are dropped.
+#ifndef AT_MUX_FRAME_SIZE
+#define AT_MUX_FRAME_SIZE 127
+#endif
+
+// Receive buffer per channel, must be a power of two. Data arriving while it is full is dropped
+// and counted, as basic option CMUX has no flow control here.
+#ifndef AT_MUX_RX_BUFFER
+#define AT_MUX_RX_BUFFER 1024
+#endif
+
+// Task that reads the physical stream and distributes frames to the channels. It should run
+// at a higher priority than the handlers' reader tasks so their buffers are filled first.
+struct ATMuxConfig {
+  const char* taskName = "AT_Mux";
+  uint32_t stackSize = 3072;
+  UBaseType_t priority = 3;
+  BaseType_t coreId = 1;
+  uint32_t pollIntervalMs = 1;
+  // Wait for the modem's answer to each channel open request in begin().
+  uint32_t openTimeoutMs = 1000;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ATMux.settings.h"
+
+// 3GPP TS 27.010 basic option framing:
+//   F9 | address | control | length (1 or 2 bytes) | information | FCS | F9
+// The address holds the DLCI, the command/response bit and EA; the FCS covers address, control
+// and length for the UIH and channel setup frames used here.
+namespace ATMuxFrame {
+
+constexpr uint8_t kFlag = 0xF9;
+constexpr uint8_t kEA = 0x01;
+constexpr uint8_t kCR = 0x02;
+constexpr uint8_t kPF = 0x10;
+
+// Control field values with the P/F bit cleared.
+constexpr uint8_t kSABM = 0x2F;  // Open a channel
+constexpr uint8_t kUA = 0x63;    // Acknowledge
+constexpr uint8_t kDM = 0x0F;    // Refuse, channel disconnected
+constexpr uint8_t kDISC = 0x43;  // Close a channel
+constexpr uint8_t kUIH = 0xEF;   // Data
+
+// Control channel (DLCI 0) message types with EA set and C/R cleared.
+constexpr uint8_t kCLD = 0xC1;  // Multiplexer close down
+constexpr uint8_t kMSC = 0xE1;  // Modem status
+
+// Flags, address, control, two length bytes and FCS.
+constexpr size_t kOverhead = 7;
+constexpr size_t kMaxFrame = AT_MUX_FRAME_SIZE + kOverhead;
+
+// Reflected CRC-8 (polynomial 0x07, initial value 0xFF) as specified in 27.010 annex B.
+inline uint8_t fcs(const uint8_t* data, size_t length) {
+  uint8_t crc = 0xFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) { crc = (crc & 1) ? (crc >> 1) ^ 0xE0 : crc >> 1; }
+  }
+  return 0xFF - crc;
+}
+
+// Writes a frame to out, which must hold length + kOverhead bytes, and returns its size. The
+// initiator sets C/R on commands and UIH data and clears it on responses.
+inline size_t encode(
+    uint8_t* out, uint8_t dlci, uint8_t control, bool command, const uint8_t* data,
+    size_t length) {
+  size_t n = 0;
+  out[n++] = kFlag;
+  out[n++] = static_cast<uint8_t>((dlci << 2) | (command ? kCR : 0) | kEA);
+  out[n++] = control;
+  if (length < 128) {
+    out[n++] = static_cast<uint8_t>((length << 1) | kEA);
+  } else {
+    out[n++] = static_cast<uint8_t>(length << 1);
+    out[n++] = static_cast<uint8_t>(length >> 7);
+  }
+  uint8_t check = fcs(out + 1, n - 1);
+  if (length) { memcpy(out + n, data, length); }
+  n += length;
+  out[n++] = check;
+  out[n++] = kFlag;
+  return n;
+}
+
+}  // namespace ATMuxFrame
+
+// Byte-wise frame parser. Frames with a bad FCS, a missing closing flag or an information field
+// above AT_MUX_FRAME_SIZE are reported as errors and skipped up to the next flag.
+class ATMuxDecoder {
+ public:
+  enum class Result { NONE, FRAME, ERROR };
+
+ private:
+  enum class State { FLAG, ADDRESS, CONTROL, LENGTH, LENGTH2, DATA, CHECK, END };
+
+  State state = State::FLAG;
+  uint8_t header[4] = {};
+  size_t headerLength = 0;
+  size_t expected = 0;
+  size_t received = 0;
+  uint8_t buffer[AT_MUX_FRAME_SIZE];
+
+  Result fail() {
+    state = State::FLAG;
+    return Result::ERROR;
+  }
+
+  Result startData() {
+    if (expected > AT_MUX_FRAME_SIZE) { return fail(); }
+    received = 0;
+    state = expected ? State::DATA : State::CHECK;
+    return Result::NONE;
+  }
+
+ public:
+  Result feed(uint8_t byte) {
+    switch (state) {
+      case State::FLAG:
+        if (byte == ATMuxFrame::kFlag) { state = State::ADDRESS; }
+        return Result::NONE;
+      case State::ADDRESS:
+        if (byte == ATMuxFrame::kFlag) { return Result::NONE; }  // Consecutive flags
+        if (!(byte & ATMuxFrame::kEA)) { return fail(); }
+        header[0] = byte;
+        state = State::CONTROL;
+        return Result::NONE;
+      case State::CONTROL:
+        header[1] = byte;
+        state = State::LENGTH;
+        return Result::NONE;
+      case State::LENGTH:
+        header[2] = byte;
+        headerLength = 3;
+        expected = byte >> 1;
+        if (byte & ATMuxFrame::kEA) { return startData(); }
+        state = State::LENGTH2;
+        return Result::NONE;
+      case State::LENGTH2:
+        header[3] = byte;
+        headerLength = 4;
+        expected |= static_cast<size_t>(byte) << 7;
+        return startData();
+      case State::DATA:
+        buffer[received++] = byte;
+        if (received == expected) { state = State::CHECK; }
+        return Result::NONE;
+      case State::CHECK:
+        if (byte != ATMuxFrame::fcs(header, headerLength)) { return fail(); }
+        state = State::END;
+        return Result::NONE;
+      case State::END:
+        if (byte != ATMuxFrame::kFlag) { return fail(); }
+        state = State::ADDRESS;  // The closing flag may also open the next frame
+        return Result::FRAME;
+    }
+    return Result::NONE;
+  }
+
+  // Fields of the last frame, valid until the next feed().
+  uint8_t dlci() const { return header[0] >> 2; }
+  uint8_t control() const { return static_cast<uint8_t>(header[1] & ~ATMuxFrame::kPF); }
+  const uint8_t* data() const { return buffer; }
+  size_t length() const { return expected; }
+
+  void reset() { state = State::FLAG; }
+};
@@ -1,85 +1,154 @@
 #include "ATPromise.h"
 
-#include <esp_log.h>
+#include <cstring>
+#include <new>
 
-ATPromise::ATPromise(uint32_t id, uint32_t timeout)
-    : commandId(id), response(nullptr), timeoutMs(timeout) {
+#include "../ATLog/ATLog.h"
+
+void ATPromiseDeleter::operator()(ATPromise* promise) const {
+  if (release) {
+    release(promise, owner);
+  } else {
+    delete promise;
+  }
+}
+
+static void releaseToResource(ATPromise* promise, void* resource) {
+  promise->~ATPromise();
+  static_cast<ATMemoryResource*>(resource)->deallocate(
+      promise, sizeof(ATPromise), alignof(ATPromise));
+}
+
+ATPromisePtr ATPromise::create(uint32_t id, uint32_t timeout, ATMemoryResource* resource) {
+  void* storage = resource->allocate(sizeof(ATPromise), alignof(ATPromise));
+  ATPromise* promise = new (storage) ATPromise(id, timeout, resource);
+  return ATPromisePtr(promise, ATPromiseDeleter{&releaseToResource, resource});
+}
+
+ATPromise::ATPromise(uint32_t id, uint32_t timeout, ATMemoryResource* resource)
+    : commandId(id),
+      response(id, resource),
+#if !AT_STATIC_ALLOCATION
+      expectedResponses(ATAllocator<Expectation>(resource)),
+#endif
+      timeoutMs(timeout),
+      memoryResource(resource) {
+#if configSUPPORT_STATIC_ALLOCATION
+  completionSemaphore = xSemaphoreCreateBinaryStatic(&completionSemaphoreBuffer);
+#else
   completionSemaphore = xSemaphoreCreateBinary();
-  if (!completionSemaphore) { log_e("Failed to create completion semaphore"); }
-  response = new ATResponse(id);
+#endif
+  if (!completionSemaphore) { AT_LOGE("Failed to create completion semaphore"); }
 }
 
 ATPromise::~ATPromise() {
   if (completionSemaphore) { vSemaphoreDelete(completionSemaphore); }
-  delete response;
 }
 
-ATPromise* ATPromise::expect(const String& expectedResponse) {
-  log_d("Promise [%u] adding expected response: %s", commandId, expectedResponse.c_str());
-  expectedResponses.push_back(expectedResponse);
+ATPromise* ATPromise::expect(const char* expectedResponse) {
+  if (expectedResponse && strlen(expectedResponse) > AT_MATCHER_LENGTH) {
+    AT_LOGE(
+        "Promise [%u] expectation longer than AT_MATCHER_LENGTH (%d) refused", commandId,
+        AT_MATCHER_LENGTH);
+    return this;
+  }
+  return expect(ATMatcher::literal(expectedResponse));
+}
+
+ATPromise* ATPromise::expect(const ATMatcher& matcher, ATCaptures* captures) {
+  if (!matcher.isValid()) {
+    AT_LOGE("Promise [%u] invalid pattern refused", commandId);
+    return this;
+  }
+  AT_LOGD("Promise [%u] adding expected response: %s", commandId, matcher.c_str());
+#if AT_STATIC_ALLOCATION
+  if (expectedResponses.full()) {
+    AT_LOGE(
+        "Promise [%u] cannot hold more than %d expectations", commandId, AT_STATIC_EXPECTATIONS);
+    return this;
+  }
+#endif
+  expectedResponses.push_back(Expectation{matcher, captures});
   hasExpected = true;
   return this;
 }
 
 ATPromise* ATPromise::timeout(uint32_t ms) {
-  log_d("Promise [%u] setting timeout to %u ms", commandId, ms);
+  AT_LOGD("Promise [%u] setting timeout to %u ms", commandId, ms);
   timeoutMs = ms;
   return this;
 }
 
 bool ATPromise::wait() {
-  log_d("Promise [%u] waiting for completion with timeout %u ms", commandId, timeoutMs);
+  AT_LOGD("Promise [%u] waiting for completion with timeout %u ms", commandId, timeoutMs);
   if (!completionSemaphore) {
-    log_e("Promise [%u] has no completion semaphore", commandId);
+    AT_LOGE("Promise [%u] has no completion semaphore", commandId);
     return false;
   }
   bool status = xSemaphoreTake(completionSemaphore, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
   if (!status) {
-    log_w("Promise [%u] wait timed out after %u ms", commandId, timeoutMs);
+    AT_LOGW("Promise [%u] wait timed out after %u ms", commandId, timeoutMs);
   } else {
-    log_d("Promise [%u] wait completed", commandId);
+    AT_LOGD("Promise [%u] wait completed", commandId);
   }
   xSemaphoreGive(completionSemaphore);  // Allow re-waiting if needed
   return status;
 }
 
-void ATPromise::addResponseLine(const ResponseLine& line) {
+void ATPromise::addResponseLine(const ResponseLine& line, bool retain) {
   if (isCompleted()) return;
 
-  if (response == nullptr) {
-    log_e("Promise [%u] has no response object to add line to", commandId);
-    return;
+  if (retain || line.isFinalResponse()) { response.addLine(line); }
+  if (!hasFirstLine) {
+    firstLineAt = line.timestamp;
+    hasFirstLine = true;
   }
 
-  response->addLine(line);
-
   // Check if the current line matches the NEXT expected response
-  if (!expectedResponses.empty() && line.content.indexOf(expectedResponses.front()) != -1) {
-    log_d(
-        "Promise [%u] matched expected response: %s", commandId, expectedResponses.front().c_str());
-    expectedResponses.pop_front();
+  if (!expectedResponses.empty()) {
+    const Expectation& next = expectedResponses.front();
+    if (next.matcher.match(line.content.c_str(), line.content.length(), next.captures)) {
+      AT_LOGD("Promise [%u] matched expected response: %s", commandId, next.matcher.c_str());
+      expectedResponses.erase(expectedResponses.begin());
+    }
   }
 
   if (line.isFinalResponse()) {
-    log_i("Promise [%u] completed", commandId);
-    log_d("Full response:\n%s", response->getFullResponse().c_str());
-    if (completionSemaphore) { xSemaphoreGive(completionSemaphore); }
+    AT_LOGI("Promise [%u] completed", commandId);
+    AT_LOGD("Full response:\n%s", response.getFullResponse().c_str());
+    settle(line);
   }
 
   if (!hasExpected) { return; }
   if (expectedResponses.empty()) {
-    log_i("Promise [%u] completed (no more expectations)", commandId);
-    log_d("Full response:\n%s", response->getFullResponse().c_str());
-    if (completionSemaphore) { xSemaphoreGive(completionSemaphore); }
+    AT_LOGI("Promise [%u] completed (no more expectations)", commandId);
+    AT_LOGD("Full response:\n%s", response.getFullResponse().c_str());
+    settle(line);
+  }
+}
+
+void ATPromise::settle(const ResponseLine& line) {
+  if (!settled) {
+    settledAt = line.timestamp;
+    settled = true;
   }
+  if (completionSemaphore) { xSemaphoreGive(completionSemaphore); }
 }
 
-bool ATPromise::matchesExpected(const String& line) const {
+void ATPromise::resolveWith(const ATResponse& cached) {
+  for (size_t i = 0; i < cached.getLineCount(); i++) { addResponseLine(cached.getLine(i)); }
+}
+
+bool ATPromise::matchesExpected(const char* line, size_t length) const {
   if (expectedResponses.empty()) return false;
-  return line.indexOf(expectedResponses.front()) != -1;
+  return expectedResponses.front().matcher.match(line, length);
 }
 
-bool ATPromise::isCompleted() const {
-  if (response) { return response->isCompleted(); }
-  return false;
+void ATPromise::rearm() {
+  expectedResponses.clear();
+  hasExpected = false;
+  settled = false;
+  if (completionSemaphore) { xSemaphoreTake(completionSemaphore, 0); }
 }
+
+bool ATPromise::isCompleted() const { return response.isCompleted(); }
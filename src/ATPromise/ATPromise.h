@@ -2,30 +2,149 @@
 #include <Arduino.h>
 
 #include <deque>
+#include <memory>
 #include <vector>
 
+#include "../ATResponse/ATMatcher.h"
 #include "../ATResponse/ATResponse.h"
+#include "../ATStorage/ATStorage.h"
 #include "freertos/FreeRTOS.h"
 
+class ATPromise;
+
+// Releases a promise popped from the handler: deletes it, hands it back to the memory resource it
+// was created from, or returns it to the handler's pool in AT_STATIC_ALLOCATION builds.
+struct ATPromiseDeleter {
+  void (*release)(ATPromise* promise, void* owner) = nullptr;
+  void* owner = nullptr;
+
+  void operator()(ATPromise* promise) const;
+};
+
+typedef std::unique_ptr<ATPromise, ATPromiseDeleter> ATPromisePtr;
+
 class ATPromise {
  private:
+  struct Expectation {
+    ATMatcher matcher;
+    ATCaptures* captures;
+  };
+
   bool hasExpected = false;
   uint32_t commandId;
-  ATResponse* response;
+  ATResponse response;
   SemaphoreHandle_t completionSemaphore;
-  std::deque<String> expectedResponses;
+#if configSUPPORT_STATIC_ALLOCATION
+  StaticSemaphore_t completionSemaphoreBuffer;
+#endif
+#if AT_STATIC_ALLOCATION
+  ATFixedVector<Expectation, AT_STATIC_EXPECTATIONS> expectedResponses;
+#else
+  std::deque<Expectation, ATAllocator<Expectation>> expectedResponses;
+#endif
   uint32_t timeoutMs;
+  ATMemoryResource* memoryResource;
+
+  // Microsecond timestamps (micros()) for latency statistics.
+  unsigned long sentAt = 0;
+  unsigned long firstLineAt = 0;
+  unsigned long settledAt = 0;
+  bool hasFirstLine = false;
+  bool settled = false;
+  int statsSlot = -1;
+  int cacheSlot = -1;
+  ATExpectationString coalesceKey;
+  uint32_t leaderId = 0;
+  uint32_t responseKey = 0;
+  char responsePrefix[AT_RESPONSE_PREFIX_LENGTH] = {};
+  uint8_t responsePrefixLength = 0;
+  bool query = false;
+  ATDataCallback dataSink;
+
+  void settle(const ResponseLine& line);
 
  public:
-  ATPromise(uint32_t id, uint32_t timeout = 5000);
+  ATPromise(
+      uint32_t id, uint32_t timeout = 5000,
+      ATMemoryResource* resource = ATMemoryResource::defaultResource());
   ~ATPromise();
-  ATPromise* expect(const String& expectedResponse);
+  ATPromise(const ATPromise&) = delete;
+  ATPromise& operator=(const ATPromise&) = delete;
+
+  // Places the promise, its response and expectations in `resource`. The returned pointer gives
+  // the memory back to it.
+  static ATPromisePtr create(uint32_t id, uint32_t timeout, ATMemoryResource* resource);
+
+  // Waits for a line containing expectedResponse, taken literally. Expectations are met in order.
+  // Text longer than AT_MATCHER_LENGTH and invalid matchers are refused with an error log.
+  ATPromise* expect(const char* expectedResponse);
+  ATPromise* expect(const String& expectedResponse) { return expect(expectedResponse.c_str()); }
+  // Waits for a line the matcher accepts, see ATMatcher.h. The fields it captures are stored in
+  // `captures`, which must outlive the wait, when the line arrives.
+  ATPromise* expect(const ATMatcher& matcher, ATCaptures* captures = nullptr);
   ATPromise* timeout(uint32_t ms);
   bool wait();
-  void addResponseLine(const ResponseLine& line);
-  bool matchesExpected(const String& line) const;
+  // With retain false the line still drives completion and expectations but is not stored.
+  void addResponseLine(const ResponseLine& line, bool retain = true);
+  bool matchesExpected(const char* line, size_t length) const;
+  bool matchesExpected(const char* line) const { return matchesExpected(line, strlen(line)); }
+  bool matchesExpected(const String& line) const {
+    return matchesExpected(line.c_str(), line.length());
+  }
   bool isCompleted() const;
+  // Clears the expectations and the settled state so wait() blocks until the next final line,
+  // for exchanges answered in two steps such as a data prompt followed by the result.
+  void rearm();
+
+  // Set by AsyncATHandler when the command is queued for transmission.
+  void markSent(unsigned long timestampUs, int slot) {
+    sentAt = timestampUs;
+    statsSlot = slot;
+  }
+  // True once the final line or the last expected line arrived.
+  bool isSettled() const { return settled; }
+  uint32_t getFirstLineLatency() const { return hasFirstLine ? firstLineAt - sentAt : 0; }
+  uint32_t getFinalLatency() const { return settled ? settledAt - sentAt : 0; }
+  int getStatsSlot() const { return statsSlot; }
+
+  // Set by AsyncATHandler for commands registered with cacheCommand().
+  void setCacheSlot(int slot) { cacheSlot = slot; }
+  int getCacheSlot() const { return cacheSlot; }
+  // Completes the promise from a cached response, replaying its lines.
+  void resolveWith(const ATResponse& cached);
+
+  // Set by AsyncATHandler for queries it coalesces: the command text, and for a promise attached
+  // to an identical query in flight, that query's id (0 while the promise owns the exchange).
+  void setCoalesceKey(const char* command) {
+    coalesceKey = ATExpectationString(command, strlen(command), memoryResource);
+  }
+  bool hasCoalesceKey(const char* command) const { return coalesceKey == command; }
+  void attachTo(uint32_t id) { leaderId = id; }
+  uint32_t getLeaderId() const { return leaderId; }
+
+  // Set by AsyncATHandler: the response prefix the command answers with, without the ':', e.g.
+  // "+CSQ" for AT+CSQ, and its key, so lines carrying it are routed here. Prefixes longer than
+  // AT_RESPONSE_PREFIX_LENGTH are not kept. `isQuery` marks read and test commands ("...?"),
+  // whose answer may carry a URC prefix, e.g. "+CEREG:" for AT+CEREG?.
+  void setResponsePrefix(const char* prefix, size_t length, uint32_t key, bool isQuery) {
+    if (!key || length > AT_RESPONSE_PREFIX_LENGTH) { return; }
+    memcpy(responsePrefix, prefix, length);
+    responsePrefixLength = static_cast<uint8_t>(length);
+    responseKey = key;
+    query = isQuery;
+  }
+  bool isQuery() const { return query; }
+  // True when `line` starts with the response prefix; `key` and `prefixLength` describe the
+  // line's prefix. The key settles most lines; the text check rules out hash collisions.
+  bool answersWith(const char* line, size_t prefixLength, uint32_t key) const {
+    return key == responseKey && prefixLength == responsePrefixLength &&
+           memcmp(line, responsePrefix, prefixLength) == 0;
+  }
+
+  // Set by AsyncATHandler::receiveData(): binary data blocks go here instead of the response.
+  void setDataSink(const ATDataCallback& sink) { dataSink = sink; }
+  const ATDataCallback& getDataSink() const { return dataSink; }
 
-  ATResponse* getResponse() { return response; }
+  ATResponse* getResponse() { return &response; }
   uint32_t getId() const { return commandId; }
 };
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Allocation-free extraction of comma separated result fields, e.g.
+//
+//   int stat; uint32_t tac;
+//   ATFields::parse(line, "+CEREG:", ATFields::Skip(), stat, ATFields::hex(tac));
+//
+// The argument types form the format descriptor and are checked at compile time:
+//   integral variable      decimal integer (optionally quoted), range checked
+//   ATFields::hex(var)     hexadecimal integer (optionally quoted, optional 0x)
+//   ATFields::text(buf)    string copied into a char array, NUL terminated, truncated to fit
+//   std::string_view       string view into the parsed line, no copy
+//   ATFields::Skip()       ignore the field
+namespace ATFields {
+
+struct Skip {};
+
+struct Text {
+  char* buffer;
+  size_t capacity;
+};
+
+template <size_t N>
+Text text(char (&buffer)[N]) {
+  return Text{buffer, N};
+}
+
+template <typename T>
+struct Hex {
+  T& value;
+};
+
+template <typename T>
+Hex<T> hex(T& value) {
+  static_assert(std::is_integral<T>::value, "ATFields::hex() needs an integral variable");
+  return Hex<T>{value};
+}
+
+namespace detail {
+
+inline bool isLineEnd(char c) { return c == '\0' || c == '\r' || c == '\n'; }
+
+inline const char* skipSpaces(const char* p) {
+  while (*p == ' ' || *p == '\t') { p++; }
+  return p;
+}
+
+// Splits off the next field at `cursor`, honouring double quotes. Quotes are not part of the
+// returned range. Returns false once the end of the line is reached.
+inline bool nextField(const char*& cursor, const char*& begin, const char*& end) {
+  const char* p = skipSpaces(cursor);
+  if (isLineEnd(*p)) { return false; }
+
+  if (*p == '"') {
+    begin = ++p;
+    while (!isLineEnd(*p) && *p != '"') { p++; }
+    end = p;
+    if (*p == '"') { p++; }
+    p = skipSpaces(p);
+    while (!isLineEnd(*p) && *p != ',') { p++; }
+  } else {
+    begin = p;
+    while (!isLineEnd(*p) && *p != ',') { p++; }
+    end = p;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) { end--; }
+  }
+
+  if (*p == ',') { p++; }
+  cursor = p;
+  return true;
+}
+
+template <typename T>
+bool assignChecked(long long value, T& out) {
+  const unsigned long long upper = static_cast<unsigned long long>((std::numeric_limits<T>::max)());
+  if (value < static_cast<long long>((std::numeric_limits<T>::min)())) { return false; }
+  if (value > 0 && static_cast<unsigned long long>(value) > upper) { return false; }
+  out = static_cast<T>(value);
+  return true;
+}
+
+template <typename T>
+bool parseDecimal(const char* begin, const char* end, T& out) {
+  bool negative = false;
+  if (begin < end && (*begin == '-' || *begin == '+')) { negative = *begin++ == '-'; }
+  if (begin == end) { return false; }
+
+  unsigned long long magnitude = 0;
+  for (; begin < end; begin++) {
+    if (*begin < '0' || *begin > '9') { return false; }
+    magnitude = magnitude * 10 + static_cast<unsigned>(*begin - '0');
+    if (magnitude > static_cast<unsigned long long>((std::numeric_limits<long long>::max)())) {
+      return false;
+    }
+  }
+  long long value =
+      negative ? -static_cast<long long>(magnitude) : static_cast<long long>(magnitude);
+  return assignChecked(value, out);
+}
+
+template <typename T>
+bool parseHex(const char* begin, const char* end, T& out) {
+  if (end - begin > 2 && begin[0] == '0' && (begin[1] == 'x' || begin[1] == 'X')) { begin += 2; }
+  if (begin == end) { return false; }
+
+  unsigned long long value = 0;
+  for (; begin < end; begin++) {
+    char c = *begin;
+    unsigned digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (value > ((std::numeric_limits<unsigned long long>::max)() >> 4)) { return false; }
+    value = (value << 4) | digit;
+  }
+  if (value > static_cast<unsigned long long>((std::numeric_limits<T>::max)())) { return false; }
+  out = static_cast<T>(value);
+  return true;
+}
+
+template <typename T, typename Enable = void>
+struct FieldParser {
+  static_assert(
+      sizeof(T) == 0,
+      "Unsupported field type: use an integral variable, ATFields::hex(), ATFields::text(), "
+      "std::string_view or ATFields::Skip");
+};
+
+template <typename T>
+struct FieldParser<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+  static bool parse(const char* begin, const char* end, T& out) {
+    return parseDecimal(begin, end, out);
+  }
+};
+
+template <typename T>
+struct FieldParser<Hex<T>> {
+  static bool parse(const char* begin, const char* end, const Hex<T>& out) {
+    return parseHex(begin, end, out.value);
+  }
+};
+
+template <>
+struct FieldParser<Text> {
+  static bool parse(const char* begin, const char* end, const Text& out) {
+    if (out.capacity == 0) { return false; }
+    size_t length = static_cast<size_t>(end - begin);
+    if (length >= out.capacity) { length = out.capacity - 1; }
+    memcpy(out.buffer, begin, length);
+    out.buffer[length] = '\0';
+    return true;
+  }
+};
+
+template <>
+struct FieldParser<std::string_view> {
+  static bool parse(const char* begin, const char* end, std::string_view& out) {
+    out = std::string_view(begin, static_cast<size_t>(end - begin));
+    return true;
+  }
+};
+
+template <>
+struct FieldParser<Skip> {
+  static bool parse(const char*, const char*, const Skip&) { return true; }
+};
+
+template <typename Field>
+bool parseNext(const char*& cursor, int& parsed, Field&& field) {
+  using Type = typename std::decay<Field>::type;
+  static_assert(
+      !std::is_integral<Type>::value || std::is_lvalue_reference<Field>::value,
+      "Integer fields must be passed as variables");
+
+  const char* begin;
+  const char* end;
+  if (!nextField(cursor, begin, end)) { return false; }
+  if (!FieldParser<Type>::parse(begin, end, field)) { return false; }
+  parsed++;
+  return true;
+}
+
+}  // namespace detail
+
+// Parses `line` after `prefix` (leading whitespace is ignored; pass nullptr or "" for no prefix).
+// Returns -1 if the prefix does not match, otherwise the number of fields assigned before the
+// first missing or malformed one, like sscanf().
+template <typename... Fields>
+int parse(const char* line, const char* prefix, Fields&&... fields) {
+  const char* cursor = detail::skipSpaces(line);
+  if (prefix && *prefix) {
+    size_t prefixLength = strlen(prefix);
+    if (strncmp(cursor, prefix, prefixLength) != 0) { return -1; }
+    cursor += prefixLength;
+  }
+
+  int parsed = 0;
+  (void)(detail::parseNext(cursor, parsed, std::forward<Fields>(fields)) && ...);
+  return parsed;
+}
+
+}  // namespace ATFields
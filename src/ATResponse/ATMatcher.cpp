@@ -0,0 +1,190 @@
+#include "ATMatcher.h"
+
+#include <cstring>
+#include <cstdint>
+
+void ATCaptures::set(size_t index, const char* text, size_t length, int32_t number) {
+  if (index >= AT_MATCHER_CAPTURES) { return; }
+  size_t offset = index ? offsets[index - 1] + lengths[index - 1] : 0;
+  if (length > AT_MATCHER_CAPTURE_BYTES - offset) { length = AT_MATCHER_CAPTURE_BYTES - offset; }
+  memcpy(buffer + offset, text, length);
+  offsets[index] = static_cast<uint8_t>(offset);
+  lengths[index] = static_cast<uint8_t>(length);
+  numbers[index] = number;
+  count = static_cast<uint8_t>(index + 1);
+}
+
+bool ATMatcher::addLiteral(char c) {
+  if (textLength == AT_MATCHER_LENGTH) { return false; }
+  Token* last = tokenCount ? &tokens[tokenCount - 1] : nullptr;
+  if (!last || last->kind != Kind::LITERAL || last->offset + last->length != textLength) {
+    if (!addToken(Kind::LITERAL)) { return false; }
+    last = &tokens[tokenCount - 1];
+    last->offset = textLength;
+  }
+  text[textLength++] = c;
+  last->length++;
+  return true;
+}
+
+bool ATMatcher::addToken(Kind kind, int32_t min, int32_t max) {
+  if (tokenCount == AT_MATCHER_TOKENS) { return false; }
+  tokens[tokenCount++] = Token{kind, 0, 0, min, max};
+  return true;
+}
+
+// Reads a signed decimal for a %d range.
+static bool parseBound(const char*& p, int32_t& value) {
+  bool negative = *p == '-';
+  if (negative) { p++; }
+  const char* digits = p;
+  int64_t result = 0;
+  while (*p >= '0' && *p <= '9' && p - digits < 10) { result = result * 10 + (*p++ - '0'); }
+  if (p == digits) { return false; }
+  result = negative ? -result : result;
+  if (result < INT32_MIN || result > INT32_MAX) { return false; }
+  value = static_cast<int32_t>(result);
+  return true;
+}
+
+ATMatcher::ATMatcher(const char* pattern) {
+  if (!pattern) { return; }
+  const char* p = pattern;
+  if (*p == '^') {
+    anchoredStart = true;
+    p++;
+  }
+  while (*p) {
+    char c = *p++;
+    bool ok = true;
+    if (c == '$' && !*p) {
+      anchoredEnd = true;
+    } else if (c == '*') {
+      bool repeated = tokenCount && tokens[tokenCount - 1].kind == Kind::ANY;
+      ok = repeated || addToken(Kind::ANY);
+    } else if (c != '%') {
+      ok = addLiteral(c);
+    } else if (*p == 'd') {
+      p++;
+      int32_t min = INT32_MIN;
+      int32_t max = INT32_MAX;
+      if (*p == '[') {
+        p++;
+        ok = parseBound(p, min) && *p++ == ':' && parseBound(p, max) && *p++ == ']' && min <= max;
+      }
+      ok = ok && addToken(Kind::NUMBER, min, max);
+    } else if (*p == 's') {
+      p++;
+      ok = addToken(Kind::FIELD);
+    } else if (*p == '%' || *p == '*' || *p == '^' || *p == '$') {
+      ok = addLiteral(*p++);
+    } else {
+      ok = false;
+    }
+    if (!ok) { return; }
+  }
+  valid = true;
+}
+
+ATMatcher ATMatcher::literal(const char* text) {
+  ATMatcher matcher;
+  if (!text) { return matcher; }
+  while (*text && matcher.addLiteral(*text)) { text++; }
+  matcher.valid = *text == '\0';  // A cut-off literal would accept lines that differ later
+  return matcher;
+}
+
+bool ATMatcher::run(
+    size_t token, const char* cursor, const char* end, ATCaptures* captures,
+    size_t capture) const {
+  for (; token < tokenCount; token++) {
+    const Token& t = tokens[token];
+    switch (t.kind) {
+      case Kind::LITERAL:
+        if (static_cast<size_t>(end - cursor) < t.length ||
+            memcmp(cursor, text + t.offset, t.length) != 0) {
+          return false;
+        }
+        cursor += t.length;
+        break;
+
+      case Kind::ANY:
+        if (token + 1 == tokenCount) {
+          cursor = end;
+          break;
+        }
+        for (const char* next = cursor; next <= end; next++) {
+          if (run(token + 1, next, end, captures, capture)) { return true; }
+        }
+        return false;
+
+      case Kind::NUMBER: {
+        const char* p = cursor;
+        bool quoted = p < end && *p == '"';
+        if (quoted) { p++; }
+        const char* begin = p;
+        if (p < end && *p == '-') { p++; }
+        const char* digits = p;
+        int64_t value = 0;
+        while (p < end && *p >= '0' && *p <= '9' && p - digits < 10) {
+          value = value * 10 + (*p++ - '0');
+        }
+        if (p == digits) { return false; }
+        if (*begin == '-') { value = -value; }
+        if (value < t.min || value > t.max) { return false; }
+        if (captures) { captures->set(capture, begin, p - begin, static_cast<int32_t>(value)); }
+        if (quoted) {
+          if (p == end || *p != '"') { return false; }
+          p++;
+        }
+        capture++;
+        cursor = p;
+        break;
+      }
+
+      case Kind::FIELD: {
+        const char* begin = cursor;
+        const char* stop;
+        if (cursor < end && *cursor == '"') {
+          begin++;
+          stop = static_cast<const char*>(memchr(begin, '"', end - begin));
+          if (!stop) { return false; }
+          cursor = stop + 1;
+        } else {
+          stop = begin;
+          while (stop < end && *stop != ',') { stop++; }
+          cursor = stop;
+        }
+        if (captures) { captures->set(capture, begin, stop - begin, 0); }
+        capture++;
+        break;
+      }
+    }
+  }
+  return !anchoredEnd || cursor == end;
+}
+
+bool ATMatcher::match(const char* line, size_t length, ATCaptures* captures) const {
+  if (!valid || !line) { return false; }
+  while (length && (line[length - 1] == '\r' || line[length - 1] == '\n')) { length--; }
+  const char* end = line + length;
+
+  ATCaptures scratch;
+  ATCaptures* out = captures ? &scratch : nullptr;
+  bool matched = false;
+  if (anchoredStart) {
+    matched = run(0, line, end, out, 0);
+  } else if (tokenCount && tokens[0].kind == Kind::LITERAL) {
+    // Only positions holding the first literal character can start a match.
+    char first = text[tokens[0].offset];
+    for (const char* p = line; !matched && p < end; p++) {
+      p = static_cast<const char*>(memchr(p, first, end - p));
+      if (!p) { break; }
+      matched = run(0, p, end, out, 0);
+    }
+  } else {
+    for (const char* p = line; !matched && p <= end; p++) { matched = run(0, p, end, out, 0); }
+  }
+  if (matched && captures) { *captures = scratch; }
+  return matched;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <string_view>
+
+#include "ATResponse.settings.h"
+
+// Fields captured by ATMatcher::match(), in pattern order. Text is copied into the object, so
+// it stays valid after the line is gone; numbers are also available as text.
+class ATCaptures {
+ private:
+  friend class ATMatcher;
+
+  uint8_t count = 0;
+  int32_t numbers[AT_MATCHER_CAPTURES] = {};
+  uint8_t offsets[AT_MATCHER_CAPTURES] = {};
+  uint8_t lengths[AT_MATCHER_CAPTURES] = {};
+  char buffer[AT_MATCHER_CAPTURE_BYTES];
+
+  void set(size_t index, const char* text, size_t length, int32_t number);
+
+ public:
+  size_t size() const { return count; }
+  // 0 for a missing field or a %s field.
+  int32_t number(size_t index) const { return index < count ? numbers[index] : 0; }
+  // Truncated once AT_MATCHER_CAPTURE_BYTES are used up.
+  std::string_view text(size_t index) const {
+    return index < count ? std::string_view(buffer + offsets[index], lengths[index])
+                         : std::string_view();
+  }
+};
+
+// An expectation compiled once and matched without allocation. Pattern syntax:
+//
+//   ^          at the start: the line must begin with the pattern, otherwise it may start anywhere
+//   $          at the end: the line must end with the pattern (the "\r\n" is ignored)
+//   *          any run of characters
+//   %d         an integer, optionally quoted and signed; %d[lo:hi] only accepts lo..hi
+//   %s         a field up to the next ',' or the end; quotes are removed
+//   %% %* %^ %$  the character itself
+//
+// %d and %s capture their field, e.g.
+//
+//   ATCaptures fields;
+//   ATMatcher("^+CEREG: %d,%d[1:5]$").match(line, length, &fields);  // fields.number(1) is 1..5
+//
+// Matching runs over the line once for patterns without '*' anchored with '^', and tries each
+// start position otherwise. An invalid pattern matches nothing.
+class ATMatcher {
+ private:
+  enum class Kind : uint8_t { LITERAL, ANY, NUMBER, FIELD };
+
+  struct Token {
+    Kind kind;
+    uint8_t offset;  // LITERAL: text in `text`
+    uint8_t length;
+    int32_t min;  // NUMBER: accepted range
+    int32_t max;
+  };
+
+  char text[AT_MATCHER_LENGTH + 1] = {};
+  Token tokens[AT_MATCHER_TOKENS];
+  uint8_t tokenCount = 0;
+  uint8_t textLength = 0;
+  bool anchoredStart = false;
+  bool anchoredEnd = false;
+  bool valid = false;
+
+  bool addLiteral(char c);
+  bool addToken(Kind kind, int32_t min = 0, int32_t max = 0);
+  bool run(
+      size_t token, const char* cursor, const char* end, ATCaptures* captures,
+      size_t capture) const;
+
+ public:
+  ATMatcher() = default;
+  explicit ATMatcher(const char* pattern);
+
+  // Matches `text` anywhere in a line, without interpreting any characters. expect(const char*)
+  // uses this. Text longer than AT_MATCHER_LENGTH gives an invalid matcher.
+  static ATMatcher literal(const char* text);
+
+  // `line` may end in "\r\n". Fills captures, when given, only on success.
+  bool match(const char* line, size_t length, ATCaptures* captures = nullptr) const;
+  bool match(const char* line, ATCaptures* captures = nullptr) const {
+    return match(line, strlen(line), captures);
+  }
+
+  bool isValid() const { return valid; }
+  // The literal text, for logs.
+  const char* c_str() const { return text; }
+};
@@ -1,7 +1,20 @@
 #include "ATResponse.h"
 
+#include <cstring>
+
 void ATResponse::addLine(const ResponseLine& line) {
+#if AT_STATIC_ALLOCATION
+  if (lines.full()) {
+    if (!line.isFinalResponse()) { return; }
+    retainedBytes -= lines.back().content.length() + sizeof(ResponseLine);
+    lines.back() = line;
+  } else {
+    lines.push_back(line);
+  }
+#else
   lines.push_back(line);
+#endif
+  retainedBytes += line.content.length() + sizeof(ResponseLine);
   if (line.isFinalResponse()) {
     completed = true;
     success = (line.type == ResponseType::FINAL_OK);
@@ -10,14 +23,14 @@ void ATResponse::addLine(const ResponseLine& line) {
 
 String ATResponse::getFullResponse() const {
   String result = "";
-  for (const auto& line : lines) { result += line.content; }
+  for (const auto& line : lines) { result += line.content.c_str(); }
   return result;
 }
 
 String ATResponse::getDataOnly() const {
   String result = "";
   for (const auto& line : lines) {
-    if (line.type == ResponseType::INTERMEDIATE_DATA) { result += line.content; }
+    if (line.type == ResponseType::INTERMEDIATE_DATA) { result += line.content.c_str(); }
   }
   return result;
 }
@@ -25,14 +38,26 @@ String ATResponse::getDataOnly() const {
 std::vector<String> ATResponse::getDataLines() const {
   std::vector<String> result;
   for (const auto& line : lines) {
-    if (line.type == ResponseType::INTERMEDIATE_DATA) { result.push_back(line.content); }
+    if (line.type == ResponseType::INTERMEDIATE_DATA) {
+      result.push_back(String(line.content.c_str()));
+    }
   }
   return result;
 }
 
 bool ATResponse::containsResponse(const String& expected) const {
   for (const auto& line : lines) {
-    if (line.content.indexOf(expected) != -1) { return true; }
+    if (strstr(line.content.c_str(), expected.c_str())) { return true; }
   }
   return false;
 }
+
+const ResponseLine* ATResponse::findLine(const char* prefix) const {
+  size_t prefixLength = strlen(prefix);
+  for (const auto& line : lines) {
+    const char* content = line.content.c_str();
+    while (*content == ' ' || *content == '\t') { content++; }
+    if (strncmp(content, prefix, prefixLength) == 0) { return &line; }
+  }
+  return nullptr;
+}
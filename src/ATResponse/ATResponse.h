@@ -1,27 +1,54 @@
 #pragma once
 #include <Arduino.h>
 
+#include <utility>
 #include <vector>
 
+#include "ATFields.h"
 #include "ATResponse.settings.h"
 
 class ATResponse {
  private:
-  std::vector<ResponseLine> lines;
+#if AT_STATIC_ALLOCATION
+  ATFixedVector<ResponseLine, AT_STATIC_RESPONSE_LINES> lines;
+#else
+  std::vector<ResponseLine, ATAllocator<ResponseLine>> lines;
+#endif
   bool completed = false;
   bool success = false;
   uint32_t commandId = 0;
+  size_t retainedBytes = 0;
 
  public:
-  ATResponse(uint32_t id) : commandId(id) {}
+#if AT_STATIC_ALLOCATION
+  ATResponse(uint32_t id, ATMemoryResource* = nullptr) : commandId(id) {}
+#else
+  // Lines are stored in memory from `resource`; their text comes from each line's own resource.
+  ATResponse(uint32_t id, ATMemoryResource* resource = ATMemoryResource::defaultResource())
+      : lines(ATAllocator<ResponseLine>(resource)), commandId(id) {}
+#endif
 
   void addLine(const ResponseLine& line);
   String getFullResponse() const;
   String getDataOnly() const;
   std::vector<String> getDataLines() const;
   bool containsResponse(const String& expected) const;
+  const ResponseLine* findLine(const char* prefix) const;
+
+  // Parses the first line starting with `prefix` into `fields` without allocating, see
+  // ATFields::parse(). Returns -1 if no line has the prefix.
+  template <typename... Fields>
+  int scan(const char* prefix, Fields&&... fields) const {
+    const ResponseLine* line = findLine(prefix);
+    if (!line) { return -1; }
+    return ATFields::parse(line->content.c_str(), prefix, std::forward<Fields>(fields)...);
+  }
 
   bool isCompleted() const { return completed; }
   bool isSuccess() const { return success; }
   uint32_t getId() const { return commandId; }
+  size_t getLineCount() const { return lines.size(); }
+  const ResponseLine& getLine(size_t index) const { return lines[index]; }
+  // Approximate heap held by the stored lines: their text plus one ResponseLine each.
+  size_t getRetainedBytes() const { return retainedBytes; }
 };
@@ -2,7 +2,37 @@
 
 #include <Arduino.h>
 
-#include <functional>
+#include "../ATDelegate/ATDelegate.h"
+#include "../ATStorage/ATStorage.h"
+
+// Characters of literal text one ATMatcher holds, and the pieces (literals, wildcards, fields)
+// its pattern may compile to. Longer expectations are refused, not truncated.
+#ifndef AT_MATCHER_LENGTH
+#define AT_MATCHER_LENGTH 48
+#endif
+
+#ifndef AT_MATCHER_TOKENS
+#define AT_MATCHER_TOKENS 8
+#endif
+
+// Fields one ATCaptures keeps and the bytes of captured text they share.
+#ifndef AT_MATCHER_CAPTURES
+#define AT_MATCHER_CAPTURES 4
+#endif
+
+#ifndef AT_MATCHER_CAPTURE_BYTES
+#define AT_MATCHER_CAPTURE_BYTES 64
+#endif
+
+// Characters of the response prefix a promise keeps for routing, e.g. "+QIACT" for AT+QIACT=1.
+// Commands with longer names are routed by order only.
+#ifndef AT_RESPONSE_PREFIX_LENGTH
+#define AT_RESPONSE_PREFIX_LENGTH 15
+#endif
+
+static_assert(AT_MATCHER_LENGTH <= 255, "AT_MATCHER_LENGTH must fit in a byte");
+static_assert(AT_MATCHER_CAPTURE_BYTES <= 255, "AT_MATCHER_CAPTURE_BYTES must fit in a byte");
+static_assert(AT_RESPONSE_PREFIX_LENGTH <= 255, "AT_RESPONSE_PREFIX_LENGTH must fit in a byte");
 
 enum class ResponseType {
   FINAL_OK,
@@ -13,7 +43,7 @@ enum class ResponseType {
 };
 
 struct ResponseLine {
-  String content;
+  ATLineString content;
   ResponseType type;
   uint32_t commandId;  // 0 for unsolicited
   unsigned long timestamp;
@@ -24,4 +54,14 @@ struct ResponseLine {
   }
 };
 
-typedef std::function<void(const String& urc)> URCCallback;
+// Inline-storage callback, see ATDelegate.h. Captures larger than AT_DELEGATE_CAPACITY do not
+// compile.
+typedef ATDelegate<void(const ATLineString& urc)> URCCallback;
+
+// URC callback for addURCListener(): a view of the line as received, including "\r\n" and NUL
+// terminated, valid only during the call.
+typedef ATDelegate<void(const char* line, size_t length)> URCListener;
+
+// Receives the bytes of a binary data block (e.g. after "+QIRD: <length>") in chunks, see
+// BasicAsyncATHandler::receiveData().
+typedef ATDelegate<void(const uint8_t* data, size_t length)> ATDataCallback;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <cstring>
+
+// Lock-free single-producer/single-consumer byte ring. One task may write while another reads
+// without further locking; head and tail are free-running counters masked on access.
+template <size_t Capacity>
+class ATRingBuffer {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be 2^n");
+
+ private:
+  static constexpr size_t mask = Capacity - 1;
+
+  uint8_t buffer[Capacity];
+  std::atomic<size_t> head{0};  // Next write position, advanced by the producer
+  std::atomic<size_t> tail{0};  // Next read position, advanced by the consumer
+
+ public:
+  // Producer side. Returns the number of bytes stored, which is less than size when full.
+  size_t write(const uint8_t* data, size_t size) {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t space = Capacity - (h - tail.load(std::memory_order_acquire));
+    if (size > space) { size = space; }
+
+    size_t offset = h & mask;
+    size_t first = Capacity - offset;
+    if (first > size) { first = size; }
+    memcpy(buffer + offset, data, first);
+    memcpy(buffer, data + first, size - first);
+
+    head.store(h + size, std::memory_order_release);
+    return size;
+  }
+
+  bool push(uint8_t value) { return write(&value, 1) == 1; }
+
+  // Consumer side. Returns the number of bytes copied into out.
+  size_t read(uint8_t* out, size_t size) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t count = head.load(std::memory_order_acquire) - t;
+    if (size > count) { size = count; }
+
+    size_t offset = t & mask;
+    size_t first = Capacity - offset;
+    if (first > size) { first = size; }
+    memcpy(out, buffer + offset, first);
+    memcpy(out + first, buffer, size - first);
+
+    tail.store(t + size, std::memory_order_release);
+    return size;
+  }
+
+  int pop() {
+    uint8_t value;
+    return read(&value, 1) == 1 ? value : -1;
+  }
+
+  int peek() const {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t) { return -1; }
+    return buffer[t & mask];
+  }
+
+  // Consumer side: drops everything currently buffered.
+  void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+
+  size_t available() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+  size_t space() const { return Capacity - available(); }
+  static constexpr size_t capacity() { return Capacity; }
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Read-ahead buffer per socket, a power of two. Reads from the modem are sized to the free space
+// in it, up to AT_SOCKET_READ_CHUNK.
+#ifndef AT_SOCKET_RX_BUFFER
+#define AT_SOCKET_RX_BUFFER 2048
+#endif
+
+// Largest AT+QIRD/AT+QSSLRECV request; Quectel modems return at most 1500 bytes per read.
+#ifndef AT_SOCKET_READ_CHUNK
+#define AT_SOCKET_READ_CHUNK 1500
+#endif
+
+// Writes are collected up to this many bytes per AT+QISEND/AT+QSSLSEND, at most 1460.
+#ifndef AT_SOCKET_TX_BUFFER
+#define AT_SOCKET_TX_BUFFER 1024
+#endif
+
+// Longest host name connect() accepts.
+#ifndef AT_SOCKET_HOST_LENGTH
+#define AT_SOCKET_HOST_LENGTH 128
+#endif
+
+// Sockets one ATSocketPump serves.
+#ifndef AT_SOCKET_PUMP_SOCKETS
+#define AT_SOCKET_PUMP_SOCKETS 4
+#endif
+
+static_assert(
+    AT_SOCKET_TX_BUFFER > 0 && AT_SOCKET_TX_BUFFER <= 1460,
+    "AT_SOCKET_TX_BUFFER must be 1..1460, the AT+QISEND limit");
+
+enum class ATSocketType : uint8_t {
+  TCP,  // AT+QIOPEN, AT+QISEND, AT+QIRD
+  TLS,  // AT+QSSLOPEN, AT+QSSLSEND, AT+QSSLRECV; configure the SSL context beforehand
+};
+
+struct ATSocketConfig {
+  uint8_t contextId = 1;            // PDP context, see AT+QICSGP
+  uint8_t sslContextId = 0;         // SSL context for TLS, see AT+QSSLCFG
+  uint32_t openTimeoutMs = 150000;  // Wait for the open result URC; the modem's own limit
+  uint32_t commandTimeoutMs = 5000;
+  uint32_t closeTimeoutMs = 10000;
+};
+
+struct ATSocketPumpConfig {
+  const char* taskName = "AT_SocketPump";
+  uint32_t stackSize = 3072;
+  UBaseType_t priority = 2;
+  BaseType_t coreId = 1;
+  uint32_t readTimeoutMs = 5000;  // Per AT+QIRD; also bounds add(), remove() and end()
+  uint32_t retryIntervalMs = 20;  // Retry of a socket whose ring was full or whose read failed
+};
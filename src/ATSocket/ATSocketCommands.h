@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstdio>
+#include <string_view>
+
+#include "../ATResponse/ATFields.h"
+#include "../ATResponse/ATResponse.settings.h"
+#include "ATSocket.settings.h"
+
+// Quectel socket commands and URCs shared by ATSocketStream and ATSocketPump.
+namespace ATSocketCommands {
+
+inline bool isTLS(ATSocketType type) { return type == ATSocketType::TLS; }
+
+inline const char* openPrefix(ATSocketType type) {
+  return isTLS(type) ? "+QSSLOPEN:" : "+QIOPEN:";
+}
+inline const char* urcPrefix(ATSocketType type) { return isTLS(type) ? "+QSSLURC:" : "+QIURC:"; }
+inline const char* readPrefix(ATSocketType type) {
+  return isTLS(type) ? "+QSSLRECV:" : "+QIRD:";
+}
+
+// Writes e.g. "AT+QIRD=<id>,<length>" for command "AT+QIRD" or "AT+QSSLRECV".
+inline void format(char* out, size_t size, const char* command, uint8_t id, size_t length) {
+  snprintf(out, size, "%s=%u,%u", command, id, static_cast<unsigned>(length));
+}
+
+// Matches `+QIURC: "<event>",<id>` (`+QSSLURC:` for TLS) and returns the event.
+inline bool parseEvent(const char* line, ATSocketType type, std::string_view& event, int& id) {
+  return ATFields::parse(line, urcPrefix(type), event, id) == 2;
+}
+
+// Reads up to `length` bytes held by the modem for socket `id`, handing them to sink from the
+// reader task. Returns the number of bytes the modem sent, 0 when its buffer was empty, or -1
+// when the read failed.
+template <typename Handler>
+int receive(
+    Handler& handler, ATSocketType type, uint8_t id, size_t length, const ATDataCallback& sink,
+    uint32_t timeoutMs) {
+  char command[32];
+  format(command, sizeof(command), isTLS(type) ? "AT+QSSLRECV" : "AT+QIRD", id, length);
+  ATPromise* promise = handler.receiveData(command, sink);
+  if (!promise) { return -1; }
+  int received = -1;
+  ATResponse* response = promise->getResponse();
+  if (promise->timeout(timeoutMs)->wait() && response->isSuccess()) {
+    response->scan(readPrefix(type), received);
+  }
+  handler.popCompletedPromise(promise->getId());
+  return received;
+}
+
+}  // namespace ATSocketCommands
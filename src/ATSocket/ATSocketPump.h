@@ -0,0 +1,264 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "../ATLock/ATLock.h"
+#include "../ATRingBuffer/ATRingBuffer.h"
+#include "../AsyncATHandler.h"
+#include "ATSocketCommands.h"
+#include "freertos/FreeRTOS.h"
+
+// Opt-in downlink pump for modem sockets. A URC listener wakes the pump task on
+// `+QIURC: "recv",<id>` (`+QSSLURC:` for TLS); the task then issues AT+QIRD (AT+QSSLRECV) with
+// the largest read size the target takes until the modem reports its buffer empty. Payload goes
+// from the reader task straight into the socket's ring buffer or callback, so no application
+// task sits between the notification and the read:
+//
+//   ATSocketPump pump(handler);
+//   pump.begin();
+//   pump.add(0, ATSocketType::TCP, [](const uint8_t* data, size_t length) { ... });
+//
+// ATSocketStream::setPump() hands a stream's read-ahead buffer to the pump. Callbacks run on the
+// reader task and must not call into the handler.
+template <typename HandlerConfig = DefaultATHandlerConfig>
+class BasicATSocketPump {
+ public:
+  using Handler = BasicAsyncATHandler<HandlerConfig>;
+
+ private:
+  struct Slot {
+    std::atomic<bool> active{false};
+    uint8_t connectId = 0;
+    ATSocketType type = ATSocketType::TCP;
+    std::atomic<uint32_t> notices{0};  // "recv" URCs seen, counted by the listener
+    std::atomic<uint32_t> drained{0};  // notices as of the last read that found no data
+
+    // Either a callback, or a ring buffer behind these two functions.
+    ATDataCallback sink;
+    void* ring = nullptr;
+    size_t (*space)(void* ring) = nullptr;
+    size_t (*write)(void* ring, const uint8_t* data, size_t length) = nullptr;
+
+    BasicATSocketPump* pump = nullptr;
+  };
+
+  Handler& handler;
+  ATSocketPumpConfig config;
+  TaskHandle_t task = nullptr;
+  ATMutexLock lock;  // Held by the task while it serves a slot, and by add() and remove()
+  int listenerId = -1;
+  Slot slots[AT_SOCKET_PUMP_SOCKETS];
+
+  std::atomic<uint32_t> readCommands{0};
+  std::atomic<uint32_t> bytesDelivered{0};
+
+  template <size_t Capacity>
+  static size_t ringSpace(void* ring) {
+    return static_cast<ATRingBuffer<Capacity>*>(ring)->space();
+  }
+
+  template <size_t Capacity>
+  static size_t ringWrite(void* ring, const uint8_t* data, size_t length) {
+    return static_cast<ATRingBuffer<Capacity>*>(ring)->write(data, length);
+  }
+
+  // Runs on the reader task: only counts the notification and wakes the pump task.
+  void handleURC(const char* line) {
+    for (auto& slot : slots) {
+      std::string_view event;
+      int id = -1;
+      if (!slot.active.load(std::memory_order_acquire) ||
+          !ATSocketCommands::parseEvent(line, slot.type, event, id) || id != slot.connectId ||
+          event != "recv") {
+        continue;
+      }
+      slot.notices.fetch_add(1, std::memory_order_release);
+      TaskHandle_t pumpTask = task;
+      if (pumpTask) { xTaskNotifyGive(pumpTask); }
+      return;
+    }
+  }
+
+  bool isPending(const Slot& slot) const {
+    return slot.notices.load(std::memory_order_acquire) !=
+           slot.drained.load(std::memory_order_acquire);
+  }
+
+  // Reads until the modem buffer is empty. Returns false when the target is full or a read
+  // failed, so the slot is retried after config.retryIntervalMs.
+  bool drain(Slot& slot) {
+    while (slot.active.load(std::memory_order_acquire) && isPending(slot)) {
+      size_t length = AT_SOCKET_READ_CHUNK;
+      if (slot.ring) { length = std::min<size_t>(slot.space(slot.ring), length); }
+      if (!length) { return false; }
+
+      uint32_t notices = slot.notices.load(std::memory_order_acquire);
+      Slot* target = &slot;
+      int received = ATSocketCommands::receive(
+          handler, slot.type, slot.connectId, length,
+          ATDataCallback([target](const uint8_t* data, size_t size) {
+            if (target->ring) {
+              target->write(target->ring, data, size);
+            } else {
+              target->sink(data, size);
+            }
+            target->pump->bytesDelivered.fetch_add(size, std::memory_order_relaxed);
+          }),
+          config.readTimeoutMs);
+      readCommands.fetch_add(1, std::memory_order_relaxed);
+      if (received < 0) { return false; }
+      if (received == 0) { slot.drained.store(notices, std::memory_order_release); }
+    }
+    return true;
+  }
+
+  static void taskFunction(void* parameter) {
+    auto* pump = static_cast<BasicATSocketPump*>(parameter);
+    const TickType_t retry = std::max<TickType_t>(1, pdMS_TO_TICKS(pump->config.retryIntervalMs));
+    while (true) {
+      bool stalled = false;
+      for (auto& slot : pump->slots) {
+        if (!slot.active.load(std::memory_order_acquire) || !pump->isPending(slot)) { continue; }
+        if (!pump->lock.take(portMAX_DELAY)) { continue; }
+        stalled = !pump->drain(slot) || stalled;
+        pump->lock.give();
+      }
+      ulTaskNotifyTake(pdTRUE, stalled ? retry : portMAX_DELAY);
+    }
+  }
+
+  Slot* claim(uint8_t connectId, ATSocketType type) {
+    if (!task || !lock.take(pdMS_TO_TICKS(config.readTimeoutMs))) { return nullptr; }
+    Slot* chosen = nullptr;
+    for (auto& slot : slots) {
+      bool active = slot.active.load(std::memory_order_relaxed);
+      if (active && slot.connectId == connectId && slot.type == type) {
+        chosen = nullptr;
+        break;
+      }
+      if (!active && !chosen) { chosen = &slot; }
+    }
+    if (!chosen) {
+      lock.give();
+      return nullptr;
+    }
+    chosen->connectId = connectId;
+    chosen->type = type;
+    chosen->drained.store(chosen->notices.load(std::memory_order_relaxed));
+    chosen->sink = nullptr;
+    chosen->ring = nullptr;
+    chosen->pump = this;
+    return chosen;  // With lock held
+  }
+
+  void activate(Slot* slot) {
+    slot->active.store(true, std::memory_order_release);
+    lock.give();
+  }
+
+ public:
+  explicit BasicATSocketPump(Handler& atHandler) : handler(atHandler) {}
+  ~BasicATSocketPump() { end(); }
+  BasicATSocketPump(const BasicATSocketPump&) = delete;
+  BasicATSocketPump& operator=(const BasicATSocketPump&) = delete;
+
+  // Starts the pump task and registers its URC listener. The handler must be running.
+  bool begin(const ATSocketPumpConfig& cfg = ATSocketPumpConfig()) {
+    if (task) { return false; }
+    config = cfg;
+    if (!lock.create()) { return false; }
+    listenerId = handler.addURCListener(
+        URCListener([this](const char* line, size_t) { handleURC(line); }));
+    if (listenerId < 0) {
+      lock.destroy();
+      return false;
+    }
+    if (xTaskCreatePinnedToCore(
+            taskFunction, config.taskName, config.stackSize, this, config.priority, &task,
+            config.coreId) != pdPASS) {
+      task = nullptr;
+      handler.removeURCListener(listenerId);
+      listenerId = -1;
+      lock.destroy();
+      return false;
+    }
+    return true;
+  }
+
+  // Stops the task once it is between reads and forgets all sockets.
+  void end() {
+    if (!task) { return; }
+    handler.removeURCListener(listenerId);
+    listenerId = -1;
+    bool locked = lock.take(pdMS_TO_TICKS(config.readTimeoutMs));
+    TaskHandle_t taskToDelete = task;
+    task = nullptr;
+    vTaskDelete(taskToDelete);
+    for (auto& slot : slots) { slot.active.store(false, std::memory_order_release); }
+    if (locked) { lock.give(); }
+    lock.destroy();
+  }
+
+  // Delivers the data of socket connectId to sink, in chunks of any size. Add the socket before
+  // opening it so no notification is missed. Returns false when the socket is already added,
+  // all AT_SOCKET_PUMP_SOCKETS slots are in use or begin() was not called.
+  bool add(uint8_t connectId, ATSocketType type, const ATDataCallback& sink) {
+    if (!sink) { return false; }
+    Slot* slot = claim(connectId, type);
+    if (!slot) { return false; }
+    slot->sink = sink;
+    activate(slot);
+    return true;
+  }
+
+  // Fills ring with the data of socket connectId, reading no more than fits. Reads resume once
+  // the consumer made room, within config.retryIntervalMs or on wake().
+  template <size_t Capacity>
+  bool add(uint8_t connectId, ATSocketType type, ATRingBuffer<Capacity>& ring) {
+    Slot* slot = claim(connectId, type);
+    if (!slot) { return false; }
+    slot->ring = &ring;
+    slot->space = &ringSpace<Capacity>;
+    slot->write = &ringWrite<Capacity>;
+    activate(slot);
+    return true;
+  }
+
+  // Waits for a read in progress on the socket to finish, then forgets it.
+  void remove(uint8_t connectId, ATSocketType type) {
+    if (!task || !lock.take(pdMS_TO_TICKS(config.readTimeoutMs))) { return; }
+    for (auto& slot : slots) {
+      if (slot.active.load(std::memory_order_relaxed) && slot.connectId == connectId &&
+          slot.type == type) {
+        slot.active.store(false, std::memory_order_release);
+        slot.sink = nullptr;
+      }
+    }
+    lock.give();
+  }
+
+  // True while the modem announced data for the socket that was not read yet.
+  bool hasPendingData(uint8_t connectId, ATSocketType type) const {
+    for (const auto& slot : slots) {
+      if (slot.active.load(std::memory_order_acquire) && slot.connectId == connectId &&
+          slot.type == type) {
+        return isPending(slot);
+      }
+    }
+    return false;
+  }
+
+  // Retries stalled sockets now, e.g. after the consumer emptied a full ring buffer.
+  void wake() {
+    TaskHandle_t pumpTask = task;
+    if (pumpTask) { xTaskNotifyGive(pumpTask); }
+  }
+
+  uint32_t getReadCommands() const { return readCommands.load(std::memory_order_relaxed); }
+  uint32_t getBytesDelivered() const { return bytesDelivered.load(std::memory_order_relaxed); }
+};
+
+using ATSocketPump = BasicATSocketPump<>;
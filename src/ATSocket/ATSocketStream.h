@@ -0,0 +1,276 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "../ATRingBuffer/ATRingBuffer.h"
+#include "../AsyncATHandler.h"
+#include "ATSocket.settings.h"
+#include "ATSocketCommands.h"
+#include "ATSocketPump.h"
+
+// Stream over a TCP or TLS socket on a Quectel modem, for clients such as HttpClient or an MQTT
+// library. Received data is pulled with AT+QIRD (AT+QSSLRECV) only after the modem announced it
+// with a "recv" URC, and then in requests as large as the read-ahead buffer allows, so small
+// reads are served locally. Writes are collected and sent as one AT+QISEND (AT+QSSLSEND) when
+// the buffer fills, on flush() or before the next read:
+//
+//   ATSocketStream socket(handler, 0);
+//   if (socket.connect("example.com", 80)) {
+//     socket.print("GET / HTTP/1.1\r\nHost: example.com\r\n\r\n");
+//     while (socket.connected()) { int c = socket.read(); ... }
+//     socket.stop();
+//   }
+//
+// Call from one task only. The handler must be running; its reader task passes the data
+// straight into the read-ahead buffer.
+template <typename HandlerConfig = DefaultATHandlerConfig>
+class BasicATSocketStream : public Stream {
+ public:
+  using Handler = BasicAsyncATHandler<HandlerConfig>;
+  using Pump = BasicATSocketPump<HandlerConfig>;
+
+ private:
+  static constexpr size_t kCommandLength = AT_SOCKET_HOST_LENGTH + 64;
+
+  Handler& handler;
+  uint8_t connectId;
+  ATSocketConfig config;
+  ATSocketType type = ATSocketType::TCP;
+  int listenerId = -1;
+  Pump* pump = nullptr;
+
+  ATRingBuffer<AT_SOCKET_RX_BUFFER> rx;
+  uint8_t tx[AT_SOCKET_TX_BUFFER];
+  size_t txLength = 0;
+
+  // Set by the URC listener on the reader task.
+  std::atomic<bool> open{false};
+  std::atomic<int> openResult{-1};
+  std::atomic<uint32_t> recvNotices{0};
+  // recvNotices as of the last read that found the modem buffer empty.
+  uint32_t drainedNotices = 0;
+  bool allocated = false;  // The connect id is in use on the modem until stop()
+
+  SemaphoreHandle_t opened = nullptr;
+#if configSUPPORT_STATIC_ALLOCATION
+  StaticSemaphore_t openedBuffer;
+#endif
+
+  uint32_t readCommands = 0;
+  uint32_t sendCommands = 0;
+
+  bool isTLS() const { return ATSocketCommands::isTLS(type); }
+
+  void handleURC(const char* line) {
+    int id = -1;
+    int result = -1;
+    if (ATFields::parse(line, ATSocketCommands::openPrefix(type), id, result) == 2) {
+      if (id == connectId) {
+        openResult.store(result, std::memory_order_release);
+        xSemaphoreGive(opened);
+      }
+      return;
+    }
+    std::string_view event;
+    if (!ATSocketCommands::parseEvent(line, type, event, id) || id != connectId) { return; }
+    if (event == "recv") {
+      recvNotices.fetch_add(1, std::memory_order_release);
+    } else if (event == "closed") {
+      open.store(false, std::memory_order_release);
+    }
+  }
+
+  bool hasPendingData() const {
+    if (pump) { return pump->hasPendingData(connectId, type); }
+    return recvNotices.load(std::memory_order_acquire) != drainedNotices;
+  }
+
+  // Sends the collected writes, dropping them if the modem refuses.
+  bool sendBuffered() {
+    if (!txLength) { return true; }
+    char command[32];
+    ATSocketCommands::format(
+        command, sizeof(command), isTLS() ? "AT+QSSLSEND" : "AT+QISEND", connectId, txLength);
+    ATPromise* promise = handler.sendWithPayload(command, tx, txLength, config.commandTimeoutMs);
+    bool sent = promise && promise->timeout(config.commandTimeoutMs)->wait() &&
+                promise->getResponse()->isSuccess();
+    if (promise) { handler.popCompletedPromise(promise->getId()); }
+    if (!sent) { AT_LOGW("Socket %u dropped %u bytes", connectId, unsigned(txLength)); }
+    sendCommands++;
+    txLength = 0;
+    return sent;
+  }
+
+  // Reads what the modem holds for the socket, up to the free space in rx. Returns false once
+  // the modem buffer is empty or the read failed.
+  bool pull() {
+    size_t length = std::min<size_t>(rx.space(), AT_SOCKET_READ_CHUNK);
+    if (!length) { return false; }
+    uint32_t notices = recvNotices.load(std::memory_order_acquire);
+    // The ring has room for the whole answer, so the sink never drops bytes.
+    int received = ATSocketCommands::receive(
+        handler, type, connectId, length,
+        ATDataCallback([this](const uint8_t* data, size_t size) { rx.write(data, size); }),
+        config.commandTimeoutMs);
+    readCommands++;
+    if (received == 0) { drainedNotices = notices; }
+    return received > 0;
+  }
+
+  // Pending writes go out before reading, since a client waits for the answer to them. With a
+  // pump the data arrives by itself; an empty buffer only gets it to retry a stalled read.
+  void fill() {
+    if (txLength) { sendBuffered(); }
+    if (rx.available() || !hasPendingData()) { return; }
+    if (pump) {
+      pump->wake();
+    } else {
+      pull();
+    }
+  }
+
+ public:
+  BasicATSocketStream(
+      Handler& atHandler, uint8_t id = 0, const ATSocketConfig& socketConfig = ATSocketConfig())
+      : handler(atHandler), connectId(id), config(socketConfig) {
+#if configSUPPORT_STATIC_ALLOCATION
+    opened = xSemaphoreCreateBinaryStatic(&openedBuffer);
+#else
+    opened = xSemaphoreCreateBinary();
+#endif
+  }
+  // Does not close the socket on the modem; call stop() first.
+  ~BasicATSocketStream() {
+    if (listenerId >= 0) { handler.removeURCListener(listenerId); }
+    if (opened) { vSemaphoreDelete(opened); }
+  }
+  BasicATSocketStream(const BasicATSocketStream&) = delete;
+  BasicATSocketStream& operator=(const BasicATSocketStream&) = delete;
+
+  // Lets pump fill the read-ahead buffer as data arrives instead of reading on demand. Set
+  // before connect(); pump must be running and outlive the socket.
+  void setPump(Pump* socketPump) { pump = socketPump; }
+
+  // Opens the socket in buffer access mode and waits up to config.openTimeoutMs for the result.
+  bool connect(const char* host, uint16_t port, ATSocketType socketType = ATSocketType::TCP) {
+    if (allocated || !opened || !host || strlen(host) > AT_SOCKET_HOST_LENGTH) { return false; }
+    type = socketType;
+    if (listenerId < 0) {
+      listenerId = handler.addURCListener(
+          URCListener([this](const char* line, size_t) { handleURC(line); }));
+      if (listenerId < 0) {
+        AT_LOGE("Socket %u could not register for URCs", connectId);
+        return false;
+      }
+    }
+
+    rx.clear();
+    txLength = 0;
+    drainedNotices = recvNotices.load(std::memory_order_acquire);
+    openResult.store(-1, std::memory_order_relaxed);
+    xSemaphoreTake(opened, 0);
+    if (pump && !pump->add(connectId, type, rx)) {
+      AT_LOGE("Socket %u could not be added to the pump", connectId);
+      return false;
+    }
+
+    char command[kCommandLength];
+    if (isTLS()) {
+      snprintf(
+          command, sizeof(command), "AT+QSSLOPEN=%u,%u,%u,\"%s\",%u,0", config.contextId,
+          config.sslContextId, connectId, host, port);
+    } else {
+      snprintf(
+          command, sizeof(command), "AT+QIOPEN=%u,%u,\"TCP\",\"%s\",%u,0,0", config.contextId,
+          connectId, host, port);
+    }
+    if (!handler.sendSync(command, config.commandTimeoutMs)) {
+      if (pump) { pump->remove(connectId, type); }
+      return false;
+    }
+    allocated = true;
+
+    bool answered = xSemaphoreTake(opened, pdMS_TO_TICKS(config.openTimeoutMs)) == pdTRUE;
+    int result = openResult.load(std::memory_order_acquire);
+    if (!answered || result != 0) {
+      AT_LOGW("Socket %u did not open: %d", connectId, answered ? result : -1);
+      stop();
+      return false;
+    }
+    open.store(true, std::memory_order_release);
+    return true;
+  }
+
+  // Sends pending writes and closes the socket. Unread data is discarded.
+  void stop() {
+    if (open.load(std::memory_order_acquire)) { sendBuffered(); }
+    if (allocated) {
+      char command[32];
+      snprintf(
+          command, sizeof(command), "%s=%u",
+          isTLS() ? "AT+QSSLCLOSE" : "AT+QICLOSE", connectId);
+      handler.sendSync(command, config.closeTimeoutMs);
+      allocated = false;
+    }
+    open.store(false, std::memory_order_release);
+    if (pump) { pump->remove(connectId, type); }
+    txLength = 0;
+    rx.clear();
+    drainedNotices = recvNotices.load(std::memory_order_acquire);
+    if (listenerId >= 0) {
+      handler.removeURCListener(listenerId);
+      listenerId = -1;
+    }
+  }
+
+  // True while the socket is open or received data is left to read.
+  bool connected() {
+    return open.load(std::memory_order_acquire) || rx.available() || hasPendingData();
+  }
+
+  int available() override {
+    fill();
+    return static_cast<int>(rx.available());
+  }
+  int read() override {
+    fill();
+    return rx.pop();
+  }
+  int peek() override {
+    fill();
+    return rx.peek();
+  }
+  // Copies up to size buffered bytes, pulling from the modem first when none are.
+  size_t read(uint8_t* buffer, size_t size) {
+    fill();
+    return rx.read(buffer, size);
+  }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  // Returns fewer than size bytes once the socket is closed or a send failed.
+  size_t write(const uint8_t* buffer, size_t size) override {
+    size_t written = 0;
+    while (written < size && open.load(std::memory_order_acquire)) {
+      if (txLength == AT_SOCKET_TX_BUFFER && !sendBuffered()) { break; }
+      size_t chunk = std::min<size_t>(size - written, AT_SOCKET_TX_BUFFER - txLength);
+      memcpy(tx + txLength, buffer + written, chunk);
+      txLength += chunk;
+      written += chunk;
+    }
+    return written;
+  }
+  void flush() override { sendBuffered(); }
+
+  uint8_t getConnectId() const { return connectId; }
+  // AT round trips so far, to check that reads and writes are batched.
+  uint32_t getReadCommands() const { return readCommands; }
+  uint32_t getSendCommands() const { return sendCommands; }
+};
+
+using ATSocketStream = BasicATSocketStream<>;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "../ATResponse/ATResponse.settings.h"
+
+static constexpr size_t kResponseTypeCount = static_cast<size_t>(ResponseType::UNSOLICITED) + 1;
+
+struct ATCounterSnapshot {
+  uint32_t rxBytes = 0;
+  uint32_t txBytes = 0;
+  uint32_t linesFramed = 0;
+  uint32_t linesByType[kResponseTypeCount] = {};  // Indexed by ResponseType
+  uint32_t urcsDispatched = 0;
+  uint32_t lineOverflows = 0;       // Line buffer cleared after exceeding its limit
+  uint32_t sendMutexTimeouts = 0;   // sendCommand() gave up on the promise mutex
+  uint32_t routeMutexTimeouts = 0;  // Reader task dropped a line waiting for the promise mutex
+  uint32_t orphanLines = 0;         // Non-URC lines with no pending promise
+  uint32_t admissionRejects = 0;    // sendCommand() refused at the in-flight limit
+  uint32_t admissionTimeouts = 0;   // sendCommand() blocked and no slot freed in time
+  uint32_t readerWakeups = 0;       // Reader task polls, including early wakes by sendCommand()
+  uint32_t cacheHits = 0;           // Cached commands answered from the response cache
+  uint32_t cacheMisses = 0;         // Cached commands sent to the modem
+  uint32_t coalescedCommands = 0;   // Queries attached to an identical one in flight
+  uint32_t prefixRoutedLines = 0;   // Lines routed by the response prefix of their command
+  uint32_t droppedBlockBytes = 0;   // Data block bytes no pending command asked for
+  uint32_t cutFrames = 0;           // Multi-line URCs closed or dropped before complete
+
+  uint32_t lines(ResponseType type) const { return linesByType[static_cast<size_t>(type)]; }
+};
+
+// Event counters updated from the reader task and senders. Relaxed atomics: each counter is
+// exact, but a snapshot is not a consistent cut across counters.
+class ATCounters {
+ private:
+  static uint32_t load(const std::atomic<uint32_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+  }
+
+ public:
+  std::atomic<uint32_t> rxBytes{0};
+  std::atomic<uint32_t> txBytes{0};
+  std::atomic<uint32_t> linesFramed{0};
+  std::atomic<uint32_t> linesByType[kResponseTypeCount] = {};
+  std::atomic<uint32_t> urcsDispatched{0};
+  std::atomic<uint32_t> lineOverflows{0};
+  std::atomic<uint32_t> sendMutexTimeouts{0};
+  std::atomic<uint32_t> routeMutexTimeouts{0};
+  std::atomic<uint32_t> orphanLines{0};
+  std::atomic<uint32_t> admissionRejects{0};
+  std::atomic<uint32_t> admissionTimeouts{0};
+  std::atomic<uint32_t> readerWakeups{0};
+  std::atomic<uint32_t> cacheHits{0};
+  std::atomic<uint32_t> cacheMisses{0};
+  std::atomic<uint32_t> coalescedCommands{0};
+  std::atomic<uint32_t> prefixRoutedLines{0};
+  std::atomic<uint32_t> droppedBlockBytes{0};
+  std::atomic<uint32_t> cutFrames{0};
+
+  static void add(std::atomic<uint32_t>& counter, uint32_t amount = 1) {
+    counter.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  void countLine(ResponseType type) {
+    add(linesFramed);
+    add(linesByType[static_cast<size_t>(type)]);
+  }
+
+  ATCounterSnapshot snapshot() const {
+    ATCounterSnapshot out;
+    out.rxBytes = load(rxBytes);
+    out.txBytes = load(txBytes);
+    out.linesFramed = load(linesFramed);
+    for (size_t i = 0; i < kResponseTypeCount; i++) { out.linesByType[i] = load(linesByType[i]); }
+    out.urcsDispatched = load(urcsDispatched);
+    out.lineOverflows = load(lineOverflows);
+    out.sendMutexTimeouts = load(sendMutexTimeouts);
+    out.routeMutexTimeouts = load(routeMutexTimeouts);
+    out.orphanLines = load(orphanLines);
+    out.admissionRejects = load(admissionRejects);
+    out.admissionTimeouts = load(admissionTimeouts);
+    out.readerWakeups = load(readerWakeups);
+    out.cacheHits = load(cacheHits);
+    out.cacheMisses = load(cacheMisses);
+    out.coalescedCommands = load(coalescedCommands);
+    out.prefixRoutedLines = load(prefixRoutedLines);
+    out.droppedBlockBytes = load(droppedBlockBytes);
+    out.cutFrames = load(cutFrames);
+    return out;
+  }
+};
@@ -0,0 +1,107 @@
+#include "ATStats.h"
+
+#include <cstring>
+
+size_t ATLatencyHistogram::bucketFor(uint32_t value) {
+  if (value < 4) { return value; }
+  uint32_t exponent = 31 - __builtin_clz(value);
+  size_t bucket = (exponent - 1) * 4 + ((value >> (exponent - 2)) & 3);
+  return bucket < kBuckets ? bucket : kBuckets - 1;
+}
+
+uint32_t ATLatencyHistogram::upperBound(size_t bucket) {
+  if (bucket < 4) { return bucket; }
+  uint32_t exponent = bucket / 4 + 1;
+  uint32_t lower = (4 + bucket % 4) << (exponent - 2);
+  return lower + (1u << (exponent - 2)) - 1;
+}
+
+uint32_t ATLatencyHistogram::percentile(uint32_t permille) const {
+  if (total == 0) { return 0; }
+  uint64_t rank = (static_cast<uint64_t>(total) * permille + 999) / 1000;
+  if (rank == 0) { rank = 1; }
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      uint32_t bound = i == kBuckets - 1 ? maxValue : upperBound(i);
+      return bound < maxValue ? bound : maxValue;
+    }
+  }
+  return maxValue;
+}
+
+void ATLatencyHistogram::record(uint32_t value) {
+  counts[bucketFor(value)]++;
+  total++;
+  if (value > maxValue) { maxValue = value; }
+}
+
+void ATLatencyHistogram::summarize(ATLatencySummary& out) const {
+  out.p50 = percentile(500);
+  out.p95 = percentile(950);
+  out.p99 = percentile(990);
+  out.max = maxValue;
+}
+
+int ATStats::slotFor(const char* text) {
+  size_t length = 0;
+  while (text[length] && text[length] != '=' && text[length] != '?' &&
+         length < AT_STATS_PREFIX_LENGTH - 1) {
+    length++;
+  }
+
+  for (size_t i = 0; i < used; i++) {
+    if (strncmp(slots[i].prefix, text, length) == 0 && slots[i].prefix[length] == '\0') {
+      return static_cast<int>(i);
+    }
+  }
+
+  if (used < AT_STATS_MAX_COMMANDS - 1) {
+    memcpy(slots[used].prefix, text, length);
+    slots[used].prefix[length] = '\0';
+    return static_cast<int>(used++);
+  }
+  if (used < AT_STATS_MAX_COMMANDS) {
+    strcpy(slots[used].prefix, "*");
+    used++;
+  }
+  return AT_STATS_MAX_COMMANDS - 1;
+}
+
+void ATStats::recordCompletion(int slot, uint32_t firstLineUs, uint32_t finalUs, bool error) {
+  if (slot < 0 || static_cast<size_t>(slot) >= used) { return; }
+  slots[slot].firstLine.record(firstLineUs);
+  slots[slot].final.record(finalUs);
+  if (error) { slots[slot].errors++; }
+}
+
+void ATStats::recordTimeout(int slot) {
+  if (slot < 0 || static_cast<size_t>(slot) >= used) { return; }
+  slots[slot].timeouts++;
+}
+
+bool ATStats::get(size_t index, ATCommandStats& out) const {
+  if (index >= used) { return false; }
+  const Slot& slot = slots[index];
+  memcpy(out.prefix, slot.prefix, sizeof(out.prefix));
+  out.completed = slot.final.count();
+  out.errors = slot.errors;
+  out.timeouts = slot.timeouts;
+  slot.firstLine.summarize(out.firstLine);
+  slot.final.summarize(out.final);
+  return true;
+}
+
+int ATStats::find(const char* prefix) const {
+  for (size_t i = 0; i < used; i++) {
+    if (strcmp(slots[i].prefix, prefix) == 0) { return static_cast<int>(i); }
+  }
+  return -1;
+}
+
+void ATStats::reset() {
+  for (size_t i = 0; i < used; i++) { slots[i] = Slot(); }
+  used = 0;
+}
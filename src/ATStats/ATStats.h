@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ATStats.settings.h"
+
+// Fixed-size log-linear histogram of microsecond latencies: four buckets per power of two, so
+// recording is a few shifts and one increment, with no allocation.
+class ATLatencyHistogram {
+ public:
+  static constexpr size_t kBuckets = 96;  // Values from 2^24 us (~17 s) up share the last one
+
+ private:
+  uint32_t counts[kBuckets] = {};
+  uint32_t total = 0;
+  uint32_t maxValue = 0;
+
+  static size_t bucketFor(uint32_t value);
+  static uint32_t upperBound(size_t bucket);
+  uint32_t percentile(uint32_t permille) const;
+
+ public:
+  void record(uint32_t value);
+  void summarize(ATLatencySummary& out) const;
+  uint32_t count() const { return total; }
+};
+
+// Per-command-prefix latency aggregation. Not synchronized; AsyncATHandler guards it with its
+// promise mutex.
+class ATStats {
+ private:
+  struct Slot {
+    char prefix[AT_STATS_PREFIX_LENGTH];
+    uint32_t errors;
+    uint32_t timeouts;
+    ATLatencyHistogram firstLine;
+    ATLatencyHistogram final;
+  };
+
+  Slot slots[AT_STATS_MAX_COMMANDS] = {};
+  size_t used = 0;
+
+ public:
+  // Returns the slot for the command's prefix (up to '=', '?' or the end), creating it if needed.
+  int slotFor(const char* command);
+  void recordCompletion(int slot, uint32_t firstLineUs, uint32_t finalUs, bool error);
+  void recordTimeout(int slot);
+
+  size_t size() const { return used; }
+  bool get(size_t index, ATCommandStats& out) const;
+  int find(const char* prefix) const;
+  void reset();
+};
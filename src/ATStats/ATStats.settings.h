@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Distinct command prefixes tracked (e.g. "AT+CSQ", "AT+QIOPEN"). Commands beyond this share
+// the last slot, reported as "*".
+#ifndef AT_STATS_MAX_COMMANDS
+#define AT_STATS_MAX_COMMANDS 8
+#endif
+
+// Longest prefix kept per slot, including the terminating NUL.
+#ifndef AT_STATS_PREFIX_LENGTH
+#define AT_STATS_PREFIX_LENGTH 16
+#endif
+
+static_assert(AT_STATS_MAX_COMMANDS >= 1, "AT_STATS_MAX_COMMANDS must be at least 1");
+
+// Latency percentiles in microseconds. Percentiles are bucket upper bounds (within 25%), max
+// is exact.
+struct ATLatencySummary {
+  uint32_t p50 = 0;
+  uint32_t p95 = 0;
+  uint32_t p99 = 0;
+  uint32_t max = 0;
+};
+
+struct ATMemoryStats {
+  size_t pendingPromises = 0;
+  size_t peakPendingPromises = 0;
+  size_t responseBytes = 0;  // ATResponse::getRetainedBytes() summed over pending promises
+  size_t peakResponseBytes = 0;
+  size_t peakLineLength = 0;  // Longest line seen by the reader, including overflowed ones
+  // Minimum free stack of the reader task from uxTaskGetStackHighWaterMark() (bytes on ESP-IDF,
+  // words on vanilla FreeRTOS). 0 when INCLUDE_uxTaskGetStackHighWaterMark is disabled.
+  uint32_t readerStackHighWaterMark = 0;
+};
+
+// Reader task polling, see AsyncATHandlerConfig::pollIntervalMs.
+struct ATPollStats {
+  uint32_t intervalMs = 0;     // Current sleep between polls
+  float wakeupsPerSecond = 0;  // Over the last completed window of at least one second
+};
+
+struct ATCommandStats {
+  char prefix[AT_STATS_PREFIX_LENGTH] = {};
+  uint32_t completed = 0;  // Commands that reached a final result or their last expectation
+  uint32_t errors = 0;     // ERROR or +CME ERROR results
+  uint32_t timeouts = 0;   // sendSync() waits that timed out
+  ATLatencySummary firstLine;  // From transmit to the first response line (often the echo)
+  ATLatencySummary final;      // From transmit to the final line
+};
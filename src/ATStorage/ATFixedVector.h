@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// std::vector subset over inline storage. push_back() and emplace_back() return false instead
+// of growing when full; elements are constructed in place and never touch the heap.
+template <typename T, size_t Capacity>
+class ATFixedVector {
+  static_assert(Capacity >= 1, "Capacity must be at least 1");
+
+ private:
+  alignas(T) unsigned char storage[Capacity * sizeof(T)];
+  size_t count = 0;
+
+  T* slot(size_t index) { return reinterpret_cast<T*>(storage) + index; }
+  const T* slot(size_t index) const { return reinterpret_cast<const T*>(storage) + index; }
+
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  ATFixedVector() = default;
+  ATFixedVector(const ATFixedVector& other) {
+    for (const T& item : other) { push_back(item); }
+  }
+  ATFixedVector(ATFixedVector&& other) {
+    for (T& item : other) { push_back(std::move(item)); }
+    other.clear();
+  }
+  ATFixedVector& operator=(const ATFixedVector& other) {
+    if (this != &other) {
+      clear();
+      for (const T& item : other) { push_back(item); }
+    }
+    return *this;
+  }
+  ATFixedVector& operator=(ATFixedVector&& other) {
+    if (this != &other) {
+      clear();
+      for (T& item : other) { push_back(std::move(item)); }
+      other.clear();
+    }
+    return *this;
+  }
+  ~ATFixedVector() { clear(); }
+
+  template <typename... Args>
+  bool emplace_back(Args&&... args) {
+    if (count == Capacity) { return false; }
+    new (slot(count)) T(std::forward<Args>(args)...);
+    count++;
+    return true;
+  }
+  bool push_back(const T& value) { return emplace_back(value); }
+  bool push_back(T&& value) { return emplace_back(std::move(value)); }
+
+  // Shifts the following elements down, keeping their order.
+  iterator erase(iterator position) {
+    for (iterator it = position; it + 1 != end(); ++it) { *it = std::move(*(it + 1)); }
+    back().~T();
+    count--;
+    return position;
+  }
+
+  void clear() {
+    while (count) { slot(--count)->~T(); }
+  }
+
+  T& operator[](size_t index) { return *slot(index); }
+  const T& operator[](size_t index) const { return *slot(index); }
+  T& front() { return *slot(0); }
+  const T& front() const { return *slot(0); }
+  T& back() { return *slot(count - 1); }
+  const T& back() const { return *slot(count - 1); }
+
+  iterator begin() { return slot(0); }
+  iterator end() { return slot(count); }
+  const_iterator begin() const { return slot(0); }
+  const_iterator end() const { return slot(count); }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  bool full() const { return count == Capacity; }
+  static constexpr size_t capacity() { return Capacity; }
+};
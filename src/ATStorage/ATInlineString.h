@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstring>
+
+#include "../ATMemory/ATMemoryResource.h"
+
+// Fixed-capacity string for the String operations the library uses on stored lines. Input
+// longer than Capacity characters is truncated. Converts to String for existing callers, which
+// allocates on their side.
+template <size_t Capacity>
+class ATInlineString {
+ private:
+  char text[Capacity + 1] = {};
+  size_t size = 0;
+
+ public:
+  ATInlineString() = default;
+  ATInlineString(const char* value) { assign(value); }
+  // The resource is ignored; matches ATResourceString so callers can build either type.
+  ATInlineString(const char* value, size_t length, ATMemoryResource* = nullptr) {
+    assign(value, length);
+  }
+  ATInlineString(const String& value) { assign(value.c_str(), value.length()); }
+
+  ATInlineString& operator=(const char* value) {
+    assign(value);
+    return *this;
+  }
+  ATInlineString& operator=(const String& value) {
+    assign(value.c_str(), value.length());
+    return *this;
+  }
+
+  void assign(const char* value) { assign(value, value ? strlen(value) : 0); }
+  void assign(const char* value, size_t length) {
+    size = length < Capacity ? length : Capacity;
+    if (size) { memcpy(text, value, size); }
+    text[size] = '\0';
+  }
+
+  const char* c_str() const { return text; }
+  size_t length() const { return size; }
+  bool isEmpty() const { return size == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+  int indexOf(const char* needle) const {
+    const char* found = strstr(text, needle);
+    return found ? static_cast<int>(found - text) : -1;
+  }
+  int indexOf(const String& needle) const { return indexOf(needle.c_str()); }
+  bool startsWith(const char* prefix) const {
+    return strncmp(text, prefix, strlen(prefix)) == 0;
+  }
+
+  bool operator==(const char* other) const { return strcmp(text, other) == 0; }
+  bool operator!=(const char* other) const { return !(*this == other); }
+
+  operator String() const { return String(text); }
+};
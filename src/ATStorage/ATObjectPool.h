@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Fixed set of in-place object slots. create() and destroy() may run on different tasks; a slot
+// is claimed with a compare-exchange and returned after the destructor ran.
+template <typename T, size_t Capacity>
+class ATObjectPool {
+  static_assert(Capacity >= 1, "Capacity must be at least 1");
+
+ private:
+  alignas(T) unsigned char storage[Capacity * sizeof(T)];
+  std::atomic<bool> used[Capacity] = {};
+
+  T* slot(size_t index) { return reinterpret_cast<T*>(storage) + index; }
+
+ public:
+  ATObjectPool() = default;
+  ATObjectPool(const ATObjectPool&) = delete;
+  ATObjectPool& operator=(const ATObjectPool&) = delete;
+  ~ATObjectPool() {
+    for (size_t i = 0; i < Capacity; i++) {
+      if (used[i].load(std::memory_order_acquire)) { slot(i)->~T(); }
+    }
+  }
+
+  // Returns nullptr when every slot is taken.
+  template <typename... Args>
+  T* create(Args&&... args) {
+    for (size_t i = 0; i < Capacity; i++) {
+      bool expected = false;
+      if (used[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return new (slot(i)) T(std::forward<Args>(args)...);
+      }
+    }
+    return nullptr;
+  }
+
+  void destroy(T* object) {
+    if (!object) { return; }
+    size_t index = static_cast<size_t>(object - slot(0));
+    object->~T();
+    used[index].store(false, std::memory_order_release);
+  }
+
+  size_t available() const {
+    size_t free = 0;
+    for (size_t i = 0; i < Capacity; i++) {
+      if (!used[i].load(std::memory_order_relaxed)) { free++; }
+    }
+    return free;
+  }
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstring>
+#include <utility>
+
+#include "../ATMemory/ATMemoryResource.h"
+
+// String for stored lines and expectations whose buffer comes from an ATMemoryResource. Copies
+// and moves take the source's resource along, so text built with the handler's resource stays
+// there as it is copied into responses. Offers the same operations as ATInlineString and
+// converts to String for existing callers, which allocates on their side.
+class ATResourceString {
+ private:
+  char* text = nullptr;
+  size_t size = 0;
+  ATMemoryResource* resource;
+
+  void release() {
+    if (text) { resource->deallocate(text, size + 1, 1); }
+    text = nullptr;
+    size = 0;
+  }
+
+ public:
+  ATResourceString() : resource(ATMemoryResource::defaultResource()) {}
+  ATResourceString(const char* value, size_t length, ATMemoryResource* r = nullptr)
+      : resource(r ? r : ATMemoryResource::defaultResource()) {
+    assign(value, length);
+  }
+  ATResourceString(const char* value) : ATResourceString(value, value ? strlen(value) : 0) {}
+  ATResourceString(const String& value) : ATResourceString(value.c_str(), value.length()) {}
+
+  ATResourceString(const ATResourceString& other) : resource(other.resource) {
+    assign(other.text, other.size);
+  }
+  ATResourceString(ATResourceString&& other) noexcept
+      : text(other.text), size(other.size), resource(other.resource) {
+    other.text = nullptr;
+    other.size = 0;
+  }
+  ~ATResourceString() { release(); }
+
+  ATResourceString& operator=(const ATResourceString& other) {
+    if (this != &other) {
+      release();
+      resource = other.resource;
+      assign(other.text, other.size);
+    }
+    return *this;
+  }
+  ATResourceString& operator=(ATResourceString&& other) noexcept {
+    if (this != &other) {
+      release();
+      text = other.text;
+      size = other.size;
+      resource = other.resource;
+      other.text = nullptr;
+      other.size = 0;
+    }
+    return *this;
+  }
+  ATResourceString& operator=(const char* value) {
+    assign(value);
+    return *this;
+  }
+  ATResourceString& operator=(const String& value) {
+    assign(value.c_str(), value.length());
+    return *this;
+  }
+
+  void assign(const char* value) { assign(value, value ? strlen(value) : 0); }
+  void assign(const char* value, size_t length) {
+    char* copy = nullptr;
+    if (length) {
+      copy = static_cast<char*>(resource->allocate(length + 1, 1));
+      memcpy(copy, value, length);
+      copy[length] = '\0';
+    }
+    release();
+    text = copy;
+    size = length;
+  }
+
+  const char* c_str() const { return text ? text : ""; }
+  size_t length() const { return size; }
+  bool isEmpty() const { return size == 0; }
+  ATMemoryResource* getResource() const { return resource; }
+
+  int indexOf(const char* needle) const {
+    const char* found = strstr(c_str(), needle);
+    return found ? static_cast<int>(found - c_str()) : -1;
+  }
+  int indexOf(const String& needle) const { return indexOf(needle.c_str()); }
+  bool startsWith(const char* prefix) const {
+    return strncmp(c_str(), prefix, strlen(prefix)) == 0;
+  }
+
+  bool operator==(const char* other) const { return strcmp(c_str(), other) == 0; }
+  bool operator!=(const char* other) const { return !(*this == other); }
+
+  operator String() const { return String(c_str()); }
+};
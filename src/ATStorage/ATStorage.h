@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ATFixedVector.h"
+#include "ATInlineString.h"
+#include "ATObjectPool.h"
+#include "ATResourceString.h"
+#include "ATStorage.settings.h"
+
+// Text types used by ResponseLine and ATPromise coalescing keys: strings allocated from the
+// handler's ATMemoryResource normally, inline fixed-capacity strings with AT_STATIC_ALLOCATION.
+#if AT_STATIC_ALLOCATION
+using ATLineString = ATInlineString<AT_STATIC_LINE_LENGTH>;
+using ATExpectationString = ATInlineString<AT_STATIC_EXPECTATION_LENGTH>;
+#else
+using ATLineString = ATResourceString;
+using ATExpectationString = ATResourceString;
+#endif
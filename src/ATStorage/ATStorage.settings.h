@@ -0,0 +1,32 @@
+#pragma once
+
+// Heap-free mode. Promises come from a pool sized by the handler's MaxPendingCommands, response
+// lines, expectations and line text live in fixed-capacity containers, and semaphores are
+// static. After begin() the handler itself never allocates; String conveniences such as
+// getFullResponse() still do on the caller's side.
+#ifndef AT_STATIC_ALLOCATION
+#define AT_STATIC_ALLOCATION 0
+#endif
+
+// Characters kept per stored response line, including "\r\n". Longer lines are truncated in
+// the ATResponse; classification and routing still see the whole line.
+#ifndef AT_STATIC_LINE_LENGTH
+#define AT_STATIC_LINE_LENGTH 128
+#endif
+
+// Lines kept per ATResponse. When full, further intermediate lines are dropped and the final
+// result replaces the last line.
+#ifndef AT_STATIC_RESPONSE_LINES
+#define AT_STATIC_RESPONSE_LINES 8
+#endif
+
+// Pending expect() matchers per promise, and the longest coalesced command text.
+#ifndef AT_STATIC_EXPECTATIONS
+#define AT_STATIC_EXPECTATIONS 4
+#endif
+
+#ifndef AT_STATIC_EXPECTATION_LENGTH
+#define AT_STATIC_EXPECTATION_LENGTH 32
+#endif
+
+static_assert(AT_STATIC_RESPONSE_LINES >= 1, "AT_STATIC_RESPONSE_LINES must be at least 1");
@@ -0,0 +1,56 @@
+#include "ATTrace.h"
+
+#include <cstdio>
+
+bool ATTrace::readSlot(uint32_t sequence, ATTraceEvent& out) const {
+  const Slot& slot = slots[(sequence - 1) & (AT_TRACE_CAPACITY - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != sequence) { return false; }
+  out.sequence = sequence;
+  out.timestampUs = slot.timestampUs;
+  out.id = slot.id;
+  out.length = slot.length;
+  out.type = slot.type;
+  out.detail = slot.detail;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+size_t ATTrace::snapshot(ATTraceEvent* out, size_t maxEvents) const {
+  if (!out || maxEvents == 0) { return 0; }
+  uint32_t last = recorded();
+  uint32_t window = maxEvents < AT_TRACE_CAPACITY ? maxEvents : AT_TRACE_CAPACITY;
+  uint32_t first = last > window ? last - window + 1 : 1;
+
+  size_t count = 0;
+  for (uint32_t sequence = first; sequence <= last; sequence++) {
+    if (readSlot(sequence, out[count])) { count++; }
+  }
+  return count;
+}
+
+size_t ATTrace::dump(Stream& out) const {
+  uint32_t last = recorded();
+  uint32_t first = last > AT_TRACE_CAPACITY ? last - AT_TRACE_CAPACITY + 1 : 1;
+  char text[48];
+
+  int length = snprintf(
+      text, sizeof(text), "%s %d %u\r\n", AT_TRACE_DUMP_MAGIC, AT_TRACE_DUMP_VERSION,
+      static_cast<unsigned>(last - first + 1));
+  out.write(reinterpret_cast<const uint8_t*>(text), length);
+
+  size_t count = 0;
+  ATTraceEvent event;
+  for (uint32_t sequence = first; sequence <= last; sequence++) {
+    if (!readSlot(sequence, event)) { continue; }
+    length = snprintf(
+        text, sizeof(text), "%08x %08x %08x %04x %02x %02x\r\n",
+        static_cast<unsigned>(event.sequence), static_cast<unsigned>(event.timestampUs),
+        static_cast<unsigned>(event.id), event.length, event.type, event.detail);
+    out.write(reinterpret_cast<const uint8_t*>(text), length);
+    count++;
+  }
+
+  length = snprintf(text, sizeof(text), "%s END\r\n", AT_TRACE_DUMP_MAGIC);
+  out.write(reinterpret_cast<const uint8_t*>(text), length);
+  return count;
+}
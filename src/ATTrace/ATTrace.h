@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Stream.h>
+
+#include <atomic>
+
+#include "ATTrace.settings.h"
+
+// Fixed-size binary event trace. Any task may record; each slot is published through its
+// sequence number (a per-slot seqlock), so readers skip events that are being overwritten
+// instead of blocking writers. Recording costs one atomic increment, micros() and a 16 byte
+// store.
+class ATTrace {
+ private:
+  struct Slot {
+    std::atomic<uint32_t> sequence{0};
+    uint32_t timestampUs = 0;
+    uint32_t id = 0;
+    uint16_t length = 0;
+    uint8_t type = 0;
+    uint8_t detail = 0;
+  };
+
+  Slot slots[AT_TRACE_CAPACITY];
+  std::atomic<uint32_t> head{0};
+
+  bool readSlot(uint32_t sequence, ATTraceEvent& out) const;
+
+ public:
+  void record(ATTraceEventType type, uint32_t id = 0, uint16_t length = 0, uint8_t detail = 0) {
+    uint32_t sequence = head.fetch_add(1, std::memory_order_relaxed) + 1;
+    Slot& slot = slots[(sequence - 1) & (AT_TRACE_CAPACITY - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestampUs = micros();
+    slot.id = id;
+    slot.length = length;
+    slot.type = static_cast<uint8_t>(type);
+    slot.detail = detail;
+    slot.sequence.store(sequence, std::memory_order_release);
+  }
+
+  // Total events recorded, including overwritten ones.
+  uint32_t recorded() const { return head.load(std::memory_order_relaxed); }
+
+  // Copies up to maxEvents of the most recent events, oldest first. Returns the number copied.
+  size_t snapshot(ATTraceEvent* out, size_t maxEvents) const;
+
+  // Writes the retained events as text for tools/at_trace_decode. The dump survives being
+  // captured from a serial console together with other output.
+  size_t dump(Stream& out) const;
+};
+
+#if AT_TRACE_ENABLED
+#define AT_TRACE(trace, ...) (trace).record(__VA_ARGS__)
+#else
+#define AT_TRACE(trace, ...) ((void)0)
+#endif
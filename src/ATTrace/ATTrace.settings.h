@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Records binary trace events from the handler's hot path. Off by default; enable with
+// -DAT_TRACE_ENABLED=1 (the native CMake build does so through ASYNCAT_HANDLER_TRACE).
+#ifndef AT_TRACE_ENABLED
+#define AT_TRACE_ENABLED 0
+#endif
+
+// Events kept in the ring, must be a power of two. Older events are overwritten.
+#ifndef AT_TRACE_CAPACITY
+#define AT_TRACE_CAPACITY 256
+#endif
+
+static_assert(
+    AT_TRACE_CAPACITY > 0 && (AT_TRACE_CAPACITY & (AT_TRACE_CAPACITY - 1)) == 0,
+    "AT_TRACE_CAPACITY must be a power of two");
+
+// This header is shared with tools/at_trace_decode.cpp and must not depend on Arduino.
+enum class ATTraceEventType : uint8_t {
+  COMMAND_SENT = 1,  // id = command id, length = command length
+  LINE_FRAMED,       // length = line length including the terminator
+  LINE_OVERFLOW,     // length = discarded bytes
+  LINE_CLASSIFIED,   // detail = ResponseType
+  LINE_ROUTED,       // id = promise the line was added to
+  LINE_ORPHANED,     // No promise took the line
+  PROMISE_SETTLED,   // id = promise, detail = 1 on success
+  PROMISE_TIMEOUT,   // id = promise whose sendSync() wait timed out
+  URC_DISPATCHED,    // length = URC length
+};
+
+struct ATTraceEvent {
+  uint32_t sequence;  // 1-based position in the trace, gaps mean overwritten events
+  uint32_t timestampUs;
+  uint32_t id;
+  uint16_t length;
+  uint8_t type;
+  uint8_t detail;
+};
+
+static_assert(sizeof(ATTraceEvent) == 16, "Trace events are dumped as 16 bytes");
+
+// First token of a text dump, followed by the format version and the event count.
+#define AT_TRACE_DUMP_MAGIC "ATTRACE"
+#define AT_TRACE_DUMP_VERSION 1
+
+inline const char* atTraceEventName(uint8_t type) {
+  switch (static_cast<ATTraceEventType>(type)) {
+    case ATTraceEventType::COMMAND_SENT:
+      return "COMMAND_SENT";
+    case ATTraceEventType::LINE_FRAMED:
+      return "LINE_FRAMED";
+    case ATTraceEventType::LINE_OVERFLOW:
+      return "LINE_OVERFLOW";
+    case ATTraceEventType::LINE_CLASSIFIED:
+      return "LINE_CLASSIFIED";
+    case ATTraceEventType::LINE_ROUTED:
+      return "LINE_ROUTED";
+    case ATTraceEventType::LINE_ORPHANED:
+      return "LINE_ORPHANED";
+    case ATTraceEventType::PROMISE_SETTLED:
+      return "PROMISE_SETTLED";
+    case ATTraceEventType::PROMISE_TIMEOUT:
+      return "PROMISE_TIMEOUT";
+    case ATTraceEventType::URC_DISPATCHED:
+      return "URC_DISPATCHED";
+  }
+  return "UNKNOWN";
+}
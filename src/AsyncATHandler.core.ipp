@@ -0,0 +1,96 @@
+template <typename Config>
+BasicAsyncATHandler<Config>::BasicAsyncATHandler(ATMemoryResource* resource)
+    : memoryResource(resource ? resource : ATMemoryResource::defaultResource()) {}
+
+template <typename Config>
+BasicAsyncATHandler<Config>::~BasicAsyncATHandler() {
+  end();
+  if (slotFreed) { vSemaphoreDelete(slotFreed); }
+}
+
+template <typename Config>
+bool BasicAsyncATHandler<Config>::begin(Stream& s, const AsyncATHandlerConfig& cfg) {
+  if (readerTask) { return false; }
+  if (!cfg.stackBuffer != !cfg.taskBuffer) {
+    AT_LOGE("Static task storage needs both stackBuffer and taskBuffer");
+    return false;
+  }
+  stream = &s;
+  config = cfg;
+
+  if (!mutex.create() || !generalMutex.create()) {
+    mutex.destroy();
+    generalMutex.destroy();
+    stream = nullptr;
+    return false;
+  }
+#if !AT_STATIC_ALLOCATION
+  if (kMaxPendingCommands) { pendingPromises.reserve(kMaxPendingCommands); }
+#endif
+  if (Config::Admission == ATAdmissionPolicy::BLOCK && kMaxPendingCommands && !slotFreed) {
+#if configSUPPORT_STATIC_ALLOCATION
+    slotFreed = xSemaphoreCreateBinaryStatic(&slotFreedBuffer);
+#else
+    slotFreed = xSemaphoreCreateBinary();
+#endif
+  }
+
+  BaseType_t result = pdFAIL;
+  if (config.stackBuffer && config.taskBuffer) {
+#if configSUPPORT_STATIC_ALLOCATION
+    readerTask = xTaskCreateStaticPinnedToCore(
+        readerTaskFunction, config.taskName, config.stackSize, this, config.priority,
+        config.stackBuffer, config.taskBuffer, config.coreId);
+    result = readerTask ? pdPASS : pdFAIL;
+#else
+    AT_LOGE("Static task storage given but configSUPPORT_STATIC_ALLOCATION is disabled");
+#endif
+  } else {
+    result = xTaskCreatePinnedToCore(
+        readerTaskFunction, config.taskName, config.stackSize, this, config.priority, &readerTask,
+        config.coreId);
+  }
+
+  if (result != pdPASS) {
+    readerTask = nullptr;
+    mutex.destroy();
+    generalMutex.destroy();
+    stream = nullptr;
+    return false;
+  }
+  return true;
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::end() {
+  if (mutex) {
+    if (mutex.take(pdMS_TO_TICKS(200))) {
+      pendingPromises.clear();
+      cache.invalidate(nullptr);  // Line text may live in an arena the caller is about to reset
+      inFlight.store(0, std::memory_order_relaxed);
+      responseBytes = 0;
+      mutex.give();
+    } else {
+      AT_LOGE("Failed to acquire mutex for promise cleanup on end()");
+    }
+  }
+
+  if (readerTask) {
+    TaskHandle_t taskToDelete = readerTask;
+    readerTask = nullptr;
+    vTaskDelete(taskToDelete);
+  }
+
+  mutex.destroy();
+  generalMutex.destroy();
+  lineLength = 0;
+  blockRemaining = 0;
+  frameLineStart = 0;
+  frameBytes = 0;
+  frameSkipBytes = 0;
+  frameSkipLines = 0;
+  frameDiscarding = false;
+  heldLine = ATLineString();
+  heldFor = 0;
+  stream = nullptr;
+}
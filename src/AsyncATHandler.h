@@ -2,56 +2,210 @@
 #include <Arduino.h>
 #include <Stream.h>
 
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <memory>
 #include <vector>
 
+#include "ATCache/ATResponseCache.h"
+#include "ATLog/ATLog.h"
+#include "ATMemory/ATMemoryResource.h"
+#include "ATMemory/ATMonotonicArena.h"
 #include "ATPromise/ATPromise.h"
 #include "ATResponse/ATResponse.h"
+#include "ATStats/ATCounters.h"
+#include "ATStats/ATStats.h"
+#include "ATStorage/ATStorage.h"
+#include "ATTrace/ATTrace.h"
+#include "AsyncATHandler.settings.h"
 #include "freertos/FreeRTOS.h"
 
-class AsyncATHandler {
+// AT command handler with a background reader task. Config fixes buffer sizes, limits, the URC
+// table and the lock policy at compile time, see DefaultATHandlerConfig.
+template <typename Config = DefaultATHandlerConfig>
+class BasicAsyncATHandler {
+#if AT_BENCHMARK_PROBE
+  // Native benchmarks drive the parsing pipeline directly, without the reader task. Only the
+  // benchmark build defines AT_BENCHMARK_PROBE.
+  template <typename>
+  friend class AsyncATHandlerProbe;
+#endif
+
+ public:
+  static constexpr size_t kLineCapacity = Config::LineCapacity;
+  static constexpr size_t kMaxPendingCommands = Config::MaxPendingCommands;
+  static constexpr size_t kMaxResponseLines = Config::MaxResponseLines;
+  static constexpr uint32_t kDefaultTimeoutMs = Config::DefaultTimeoutMs;
+  static constexpr size_t kMaxCachedCommands = Config::MaxCachedCommands;
+  static constexpr bool kCoalesceQueries = Config::CoalesceQueries;
+  static constexpr size_t kMaxURCListeners = Config::MaxURCListeners;
+
+  static_assert(kLineCapacity >= 8, "LineCapacity must hold at least a result code");
+  // Also rules out an unbounded queue, where LOW commands would never be dropped.
+  static_assert(
+      Config::Admission != ATAdmissionPolicy::DROP_LOW_PRIORITY ||
+          Config::ReservedSlots < kMaxPendingCommands,
+      "DROP_LOW_PRIORITY needs ReservedSlots < MaxPendingCommands");
+#if AT_STATIC_ALLOCATION
+  static_assert(kMaxPendingCommands > 0, "AT_STATIC_ALLOCATION needs MaxPendingCommands");
+#endif
+
  private:
+  using Lock = typename Config::Lock;
+
   Stream* stream = nullptr;
   TaskHandle_t readerTask = nullptr;
-  SemaphoreHandle_t mutex = nullptr;
-  SemaphoreHandle_t generalMutex = nullptr;
+  Lock mutex;
+  Lock generalMutex;
+  AsyncATHandlerConfig config;
+  ATMemoryResource* memoryResource;
 
   void lock() {
-    configASSERT(generalMutex);
-    xSemaphoreTake(generalMutex, portMAX_DELAY);
+    configASSERT(static_cast<bool>(generalMutex));
+    generalMutex.take(portMAX_DELAY);
   }
 
   void unlock() {
-    configASSERT(generalMutex);
-    xSemaphoreGive(generalMutex);
+    configASSERT(static_cast<bool>(generalMutex));
+    generalMutex.give();
   }
 
-  String lineBuffer = "";
-  std::vector<std::unique_ptr<ATPromise>> pendingPromises;
+  // One spare byte lets a line one past the capacity complete before it is dropped, plus NUL.
+  char lineBuffer[kLineCapacity + 2];
+  size_t lineLength = 0;
+  // Raw bytes of a binary data block still to come and the promise they belong to. While
+  // non-zero, lineBuffer collects chunks of the block instead of lines. Reader task only.
+  size_t blockRemaining = 0;
+  uint32_t blockPromiseId = 0;
+  // Open Config::URCFraming frame: offset of the line being collected after its first line (0
+  // when none is open), when that first line ended, and the bytes the frame spans when its first
+  // line says so. A frame that outgrew lineBuffer is skipped: frameSkipBytes more bytes, or with
+  // frameDiscarding set frameSkipLines more lines, or up to the next final result code when both
+  // are 0. Reader task only.
+  size_t frameLineStart = 0;
+  unsigned long frameOpenedAt = 0;
+  size_t frameBytes = 0;
+  size_t frameSkipBytes = 0;
+  size_t frameSkipLines = 0;
+  bool frameDiscarding = false;
+  // A line with a pending read command's prefix that may be its answer or a URC, see
+  // holdQueryLine(). Reader task only.
+  ATLineString heldLine;
+  uint32_t heldFor = 0;
+  // Block chunks are stored as response lines when the promise has no data sink.
+#if AT_STATIC_ALLOCATION
+  static constexpr size_t kBlockChunk =
+      kLineCapacity < AT_STATIC_LINE_LENGTH ? kLineCapacity : AT_STATIC_LINE_LENGTH;
+#else
+  static constexpr size_t kBlockChunk = kLineCapacity;
+#endif
+#if AT_STATIC_ALLOCATION
+  ATObjectPool<ATPromise, kMaxPendingCommands> promisePool;
+  ATFixedVector<ATPromisePtr, kMaxPendingCommands> pendingPromises;
+
+  static void releasePromise(ATPromise* promise, void* pool) {
+    static_cast<decltype(promisePool)*>(pool)->destroy(promise);
+  }
+#else
+  // Not from memoryResource: the list outlives end(), so an arena can be reset under it.
+  std::vector<ATPromisePtr> pendingPromises;
+#endif
+  // Admitted commands, from sendCommand() until popCompletedPromise(). Claimed lock-free before
+  // lock(), so a sender blocked on admission does not hold up callers that would free a slot.
+  std::atomic<size_t> inFlight{0};
+  // Given whenever a slot frees up; created for ATAdmissionPolicy::BLOCK only.
+  SemaphoreHandle_t slotFreed = nullptr;
+#if configSUPPORT_STATIC_ALLOCATION
+  StaticSemaphore_t slotFreedBuffer;
+#endif
+  ATResponseCache<kMaxCachedCommands> cache;  // Guarded by mutex
   URCCallback urcCallback = nullptr;
+  URCListener urcListeners[kMaxURCListeners ? kMaxURCListeners : 1];  // Guarded by mutex
+  std::atomic<size_t> urcListenerCount{0};
+  ATStats stats;
+  ATCounters counters;
+  size_t peakPendingPromises = 0;
+  size_t responseBytes = 0;
+  size_t peakResponseBytes = 0;
+  std::atomic<size_t> peakLineLength{0};
+  // Published by the reader task for getPollStats() and to skip needless wakes in sendCommand().
+  std::atomic<TickType_t> pollInterval{0};
+  std::atomic<uint32_t> milliWakeupsPerSecond{0};
+#if AT_TRACE_ENABLED
+  ATTrace trace;
+#endif
 
-  uint32_t nextCommandId = 1;
+  std::atomic<uint32_t> nextCommandId{1};
 
   static void readerTaskFunction(void* parameter);
-  void processIncomingData();
-  void processCompleteLine(const String& line);
+  // Returns the number of bytes read.
+  uint32_t processIncomingData();
+  void processCompleteLine(const char* line, size_t length, bool answerCut = false);
+  void dispatchLine(size_t length, bool answerCut = false);
+  void continueFrame();
+  void skipFrame();
+  void closeFrame();
 
-  ResponseType classifyLine(const String& line);
-  ATPromise* findPromiseForResponse(const String& line);
-  void handleUnsolicitedResponse(const String& line);
+  // Only the reader task writes the peak, so a relaxed compare and store is enough.
+  void notePeakLineLength(size_t length) {
+    if (length > peakLineLength.load(std::memory_order_relaxed)) {
+      peakLineLength.store(length, std::memory_order_relaxed);
+    }
+  }
+
+  ResponseType classifyLine(const char* line, size_t length);
+  ATPromise* findPromiseForResponse(const char* line, size_t length);
+  ATPromise* findPromiseByPrefix(const char* line, bool queriesOnly = true);
+  static void setResponsePrefix(ATPromise& promise, const char* command);
+  void handleUnsolicitedResponse(const char* line, size_t length);
+  void holdQueryLine(uint32_t queryId, const char* line, size_t length);
+  void releaseHeldLine(ATPromise* answered);
+  bool isPending(uint32_t id);
+  void addLineToPromise(ATPromise* promise, const char* line, size_t length, ResponseType type);
+  bool startDataBlock(const char* line, size_t length);
+  void deliverBlockChunk();
+  ATPromisePtr createPromise(uint32_t id);
+  bool isCoalescible(const char* command) const;
+  ATPromise* attachToInFlight(const char* command);
+  void resolveAttached(uint32_t leaderId, const ATResponse& response);
+  ATSendResult acquireSlot(ATPriority priority);
+  void releaseSlot();
+  ATPromise* dispatch(
+      const char* command, ATSendResult& status, const char* prompt = nullptr,
+      const ATDataCallback* sink = nullptr);
+  bool sendAndWait(const char* command, String* response, uint32_t timeout);
+
+  // Brings a backed-off reader back to the fast poll rate for the command just sent.
+  void wakeReader() {
+    TaskHandle_t task = readerTask;
+    TickType_t fastest = std::max<TickType_t>(1, pdMS_TO_TICKS(config.pollIntervalMs));
+    if (task && pollInterval.load(std::memory_order_relaxed) > fastest) { xTaskNotifyGive(task); }
+  }
 
-  bool isLineComplete(String& buffer);
+  bool isLineComplete();
+  const ATURCFrame* bufferedFrame();
+  size_t bufferedLineEnds();
+  bool isFrameOpen();
   void cleanupCompletedPromises();
 
  public:
-  AsyncATHandler();
-  ~AsyncATHandler();
+  // Promises, responses, expectations and stored line text are allocated from `resource`
+  // (operator new when null). It must outlive the handler. Unused with AT_STATIC_ALLOCATION.
+  explicit BasicAsyncATHandler(ATMemoryResource* resource = nullptr);
+  ~BasicAsyncATHandler();
 
-  bool begin(Stream& stream);
+  bool begin(Stream& stream, const AsyncATHandlerConfig& config = AsyncATHandlerConfig());
   void end();
 
-  ATPromise* sendCommand(const String& command);
+  // Returns nullptr when the command was not sent; `result` tells why, see ATSendResult.
+  ATPromise* sendCommand(const char* command, ATPriority priority, ATSendResult* result = nullptr);
+  ATPromise* sendCommand(
+      const String& command, ATPriority priority, ATSendResult* result = nullptr) {
+    return sendCommand(command.c_str(), priority, result);
+  }
+  ATPromise* sendCommand(const char* command) { return sendCommand(command, ATPriority::NORMAL); }
+  ATPromise* sendCommand(const String& command) { return sendCommand(command.c_str()); }
 
   template <typename... Args>
   ATPromise* sendCommand(Args... parts) {
@@ -60,12 +214,92 @@ class AsyncATHandler {
     return sendCommand(command);
   }
 
-  bool sendSync(const String& command, String& response, uint32_t timeout = 5000);
-  bool sendSync(const String& command, uint32_t timeout = 5000);
+  // Sends a command that prompts for data, e.g. AT+QISEND=0,<length>, waits up to
+  // promptTimeoutMs for the '>' prompt and then writes `length` payload bytes. Returns the
+  // promise of the command, which settles with its result (e.g. "SEND OK"), or nullptr when it
+  // was not sent. Without a prompt the payload is not written and the promise settles with the
+  // modem's error or times out.
+  ATPromise* sendWithPayload(
+      const char* command, const uint8_t* payload, size_t length,
+      uint32_t promptTimeoutMs = kDefaultTimeoutMs);
 
-  std::unique_ptr<ATPromise> popCompletedPromise(uint32_t commandId);
+  // Sends a command answered by a binary data block, see Config::DataHeaders, e.g.
+  // AT+QIRD=0,1500. The block's bytes are handed to sink from the reader task, in chunks and
+  // instead of being stored in the response; the header line ("+QIRD: <length>") and the
+  // final result still are. The sink must not call into the handler.
+  ATPromise* receiveData(const char* command, const ATDataCallback& sink);
 
-  void onURC(URCCallback callback) { urcCallback = callback; }
+  bool sendSync(const String& command, String& response, uint32_t timeout = kDefaultTimeoutMs) {
+    return sendAndWait(command.c_str(), &response, timeout);
+  }
+  bool sendSync(const String& command, uint32_t timeout = kDefaultTimeoutMs) {
+    return sendAndWait(command.c_str(), nullptr, timeout);
+  }
+  bool sendSync(const char* command, uint32_t timeout = kDefaultTimeoutMs) {
+    return sendAndWait(command, nullptr, timeout);
+  }
+
+  // Opt-in cache for idempotent queries, up to Config::MaxCachedCommands commands. Within ttlMs
+  // of a successful response, sendCommand(command) returns a promise already resolved with a
+  // copy of it, without writing to the stream. A URC starting with invalidatedBy (e.g. "+CEREG:")
+  // drops the entry. Call after begin(); registrations survive end(), cached responses do not.
+  // Returns false when the table is full, the strings are too long or begin() was not called.
+  bool cacheCommand(const char* command, uint32_t ttlMs, const char* invalidatedBy = nullptr);
+  // Drops the cached response of one command, or of all commands when command is null.
+  void invalidateCache(const char* command = nullptr);
+
+  // Removes the promise from the pending list. Dropping the returned pointer frees it, or hands
+  // it back to the pool with AT_STATIC_ALLOCATION.
+  ATPromisePtr popCompletedPromise(uint32_t commandId);
+
+  // Per-command-prefix latency statistics. Copies up to maxEntries entries and returns how many
+  // were written.
+  size_t getStats(ATCommandStats* out, size_t maxEntries);
+  bool getStats(const char* prefix, ATCommandStats& out);
+  void resetStats();
+
+  // Current and peak promise and response memory plus the reader task's stack high-water mark.
+  ATMemoryStats getMemoryStats();
+
+  // Commands admitted and not yet popped, i.e. the in-flight queue depth. Lock-free.
+  size_t getPendingCount() const { return inFlight.load(std::memory_order_relaxed); }
+
+  // Current reader sleep and wakeup rate, to verify idle backoff.
+  ATPollStats getPollStats() const {
+    ATPollStats poll;
+    poll.intervalMs = pollInterval.load(std::memory_order_relaxed) * portTICK_PERIOD_MS;
+    poll.wakeupsPerSecond = milliWakeupsPerSecond.load(std::memory_order_relaxed) / 1000.0f;
+    return poll;
+  }
+
+  // Snapshot of the byte, line and drop counters. Safe to call from any task.
+  ATCounterSnapshot getCounters() const { return counters.snapshot(); }
+
+#if AT_TRACE_ENABLED
+  // Binary event trace of the send and receive path, see ATTrace.h.
+  const ATTrace& getTrace() const { return trace; }
+#endif
+
+  // The callback gets the line as an ATLineString. Callables taking `const String&` still
+  // compile but build a String, and so allocate, on every URC; take `const ATLineString&`.
+  void onURC(URCCallback callback) { urcCallback = std::move(callback); }
+  // Further URC callbacks for independent consumers such as ATSocketStream, up to
+  // Config::MaxURCListeners. They get the line without a copy and run on the reader task with
+  // the promise list locked, so they should only record the event and must not call into the
+  // handler. Call after begin(); registrations survive end(). Returns an id for
+  // removeURCListener(), or -1 when full.
+  int addURCListener(const URCListener& listener);
+  void removeURCListener(int id);
 
   Stream* getStream() { return stream; }
+  ATMemoryResource* getMemoryResource() const { return memoryResource; }
 };
+
+using AsyncATHandler = BasicAsyncATHandler<>;
+
+// Member definitions; every Config instantiates its own copy.
+#include "AsyncATHandler.core.ipp"
+#include "AsyncATHandler.ipp"
+#include "AsyncATHandler.stats.ipp"
+#include "AsyncATHandler.tasks.ipp"
+#include "AsyncATHandler.utils.ipp"
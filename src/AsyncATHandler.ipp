@@ -0,0 +1,335 @@
+template <typename Config>
+ATPromisePtr BasicAsyncATHandler<Config>::createPromise(uint32_t id) {
+#if AT_STATIC_ALLOCATION
+  return ATPromisePtr(
+      promisePool.create(id, kDefaultTimeoutMs), ATPromiseDeleter{&releasePromise, &promisePool});
+#else
+  return ATPromise::create(id, kDefaultTimeoutMs, memoryResource);
+#endif
+}
+
+template <typename Config>
+ATSendResult BasicAsyncATHandler<Config>::acquireSlot(ATPriority priority) {
+  size_t limit = kMaxPendingCommands;
+  if (Config::Admission == ATAdmissionPolicy::DROP_LOW_PRIORITY && priority == ATPriority::LOW) {
+    limit -= Config::ReservedSlots;
+  }
+  TickType_t wait = 0;
+  if (Config::Admission == ATAdmissionPolicy::BLOCK) {
+    wait = pdMS_TO_TICKS(Config::AdmissionTimeoutMs);
+  }
+  TickType_t start = xTaskGetTickCount();
+
+  for (;;) {
+    size_t current = inFlight.load(std::memory_order_relaxed);
+    while (!kMaxPendingCommands || current < limit) {
+      if (inFlight.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) {
+        return ATSendResult::SENT;
+      }
+    }
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    if (!slotFreed || elapsed >= wait) { break; }
+    xSemaphoreTake(slotFreed, wait - elapsed);
+  }
+
+  if (Config::Admission == ATAdmissionPolicy::BLOCK) {
+    AT_LOGW("Command rejected, no slot freed within %u ms", Config::AdmissionTimeoutMs);
+    ATCounters::add(counters.admissionTimeouts);
+    return ATSendResult::ADMISSION_TIMEOUT;
+  }
+  AT_LOGW("Command rejected, %u commands pending", static_cast<unsigned>(inFlight.load()));
+  ATCounters::add(counters.admissionRejects);
+  return limit < kMaxPendingCommands ? ATSendResult::DROPPED : ATSendResult::QUEUE_FULL;
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::releaseSlot() {
+  inFlight.fetch_sub(1, std::memory_order_relaxed);
+  if (slotFreed) { xSemaphoreGive(slotFreed); }
+}
+
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::sendCommand(
+    const char* command, ATPriority priority, ATSendResult* result) {
+  ATSendResult status = ATSendResult::NOT_STARTED;
+  ATPromise* rawPromise = nullptr;
+  if (stream && mutex && command) { status = acquireSlot(priority); }
+  if (status != ATSendResult::SENT) {
+    if (result) { *result = status; }
+    return nullptr;
+  }
+  // Before lock(), which a sendSync() caller holds while it waits for the query to attach to.
+  if (kCoalesceQueries && (rawPromise = attachToInFlight(command))) {
+    if (result) { *result = status; }
+    return rawPromise;
+  }
+  lock();
+  rawPromise = dispatch(command, status);
+  unlock();
+  if (result) { *result = status; }
+  return rawPromise;
+}
+
+// Called with lock() held and a slot claimed, which is released again when nothing was sent.
+// The prompt expectation and data sink are in place before the command goes out.
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::dispatch(
+    const char* command, ATSendResult& status, const char* prompt, const ATDataCallback* sink) {
+  ATPromise* rawPromise = nullptr;
+  uint32_t id = nextCommandId++;
+  ATPromisePtr promise = createPromise(id);
+  if (!promise) {
+    AT_LOGW("Command [%u] rejected, no free promise", id);
+    status = ATSendResult::NO_MEMORY;
+  } else if (mutex.take(pdMS_TO_TICKS(100))) {
+    rawPromise = promise.get();
+    if (prompt) { rawPromise->expect(prompt); }
+    if (sink) { rawPromise->setDataSink(*sink); }
+    int cacheSlot = cache.find(command);
+    const ATResponse* cached = cacheSlot >= 0 ? cache.lookup(cacheSlot, millis()) : nullptr;
+    if (cached) {
+      rawPromise->resolveWith(*cached);
+      responseBytes += rawPromise->getResponse()->getRetainedBytes();
+      if (responseBytes > peakResponseBytes) { peakResponseBytes = responseBytes; }
+    } else {
+      rawPromise->setCacheSlot(cacheSlot);
+      rawPromise->markSent(micros(), stats.slotFor(command));
+      setResponsePrefix(*rawPromise, command);
+      if (kCoalesceQueries && isCoalescible(command)) { rawPromise->setCoalesceKey(command); }
+    }
+    pendingPromises.push_back(std::move(promise));
+    if (pendingPromises.size() > peakPendingPromises) {
+      peakPendingPromises = pendingPromises.size();
+    }
+    mutex.give();
+
+    if (cached) {
+      AT_LOGI("Command [%u] answered from cache: %s", id, command);
+      ATCounters::add(counters.cacheHits);
+    } else {
+      if (cacheSlot >= 0) { ATCounters::add(counters.cacheMisses); }
+      size_t length = strlen(command);
+      AT_LOGI("Sending command [%u]: %s", id, command);
+      stream->write(reinterpret_cast<const uint8_t*>(command), length);
+      stream->write(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+      stream->flush();
+      ATCounters::add(counters.txBytes, length + 2);
+      AT_TRACE(trace, ATTraceEventType::COMMAND_SENT, id, length);
+      wakeReader();
+    }
+  } else {
+    AT_LOGE("Failed to acquire mutex for sendCommand");
+    ATCounters::add(counters.sendMutexTimeouts);
+    status = ATSendResult::BUSY;
+  }
+
+  if (!rawPromise) { releaseSlot(); }
+  return rawPromise;
+}
+
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::sendWithPayload(
+    const char* command, const uint8_t* payload, size_t length, uint32_t promptTimeoutMs) {
+  ATSendResult status = ATSendResult::NOT_STARTED;
+  if (stream && mutex && command) { status = acquireSlot(ATPriority::NORMAL); }
+  if (status != ATSendResult::SENT) { return nullptr; }
+  // Held until the payload is out, so no other command is written between prompt and payload.
+  lock();
+  ATPromise* promise = dispatch(command, status, ">");
+  if (!promise) {
+    unlock();
+    return nullptr;
+  }
+
+  bool prompted = promise->timeout(promptTimeoutMs)->wait() && !promise->isCompleted();
+  if (prompted && mutex.take(pdMS_TO_TICKS(100))) {
+    promise->rearm();
+    promise->timeout(kDefaultTimeoutMs);
+    mutex.give();
+    stream->write(payload, length);
+    stream->flush();
+    ATCounters::add(counters.txBytes, length);
+    AT_LOGI(
+        "Sent %u payload bytes for command [%u]", static_cast<unsigned>(length), promise->getId());
+  } else if (!promise->isCompleted()) {
+    AT_LOGW("Command [%u] got no data prompt, payload not sent", promise->getId());
+  }
+  unlock();
+  return promise;
+}
+
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::receiveData(
+    const char* command, const ATDataCallback& sink) {
+  ATSendResult status = ATSendResult::NOT_STARTED;
+  if (stream && mutex && command) { status = acquireSlot(ATPriority::NORMAL); }
+  if (status != ATSendResult::SENT) { return nullptr; }
+  lock();
+  ATPromise* promise = dispatch(command, status, nullptr, &sink);
+  unlock();
+  return promise;
+}
+
+template <typename Config>
+int BasicAsyncATHandler<Config>::addURCListener(const URCListener& listener) {
+  if (!kMaxURCListeners || !listener || !mutex || !mutex.take(pdMS_TO_TICKS(100))) {
+    return -1;
+  }
+  int id = -1;
+  for (size_t i = 0; i < kMaxURCListeners; i++) {
+    if (!urcListeners[i]) {
+      urcListeners[i] = listener;
+      id = static_cast<int>(i);
+      urcListenerCount.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+  }
+  mutex.give();
+  return id;
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::removeURCListener(int id) {
+  if (id < 0 || static_cast<size_t>(id) >= kMaxURCListeners || !mutex) { return; }
+  if (mutex.take(pdMS_TO_TICKS(100))) {
+    if (urcListeners[id]) {
+      urcListeners[id] = nullptr;
+      urcListenerCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    mutex.give();
+  }
+}
+
+template <typename Config>
+bool BasicAsyncATHandler<Config>::isCoalescible(const char* command) const {
+  size_t length = strlen(command);
+  if (length && command[length - 1] == '?') { return true; }
+  for (const char* coalesced : Config::CoalescedCommands::commands) {
+    if (strcmp(command, coalesced) == 0) { return true; }
+  }
+  return cache.find(command) >= 0;
+}
+
+// Gives the caller its own promise, resolved with a copy of the response when the identical
+// query in flight completes. Nothing is written to the stream.
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::attachToInFlight(const char* command) {
+  if (!isCoalescible(command) || !mutex.take(pdMS_TO_TICKS(100))) { return nullptr; }
+  ATPromise* attached = nullptr;
+  for (auto& leader : pendingPromises) {
+    if (leader->getLeaderId() || leader->isCompleted() || !leader->hasCoalesceKey(command)) {
+      continue;
+    }
+    ATPromisePtr promise = createPromise(nextCommandId++);
+    if (promise) {
+      attached = promise.get();
+      attached->setCoalesceKey(command);
+      attached->setCacheSlot(leader->getCacheSlot());
+      attached->attachTo(leader->getId());
+      pendingPromises.push_back(std::move(promise));
+      if (pendingPromises.size() > peakPendingPromises) {
+        peakPendingPromises = pendingPromises.size();
+      }
+    }
+    break;
+  }
+  mutex.give();
+
+  if (attached) {
+    AT_LOGI(
+        "Command [%u] attached to [%u]: %s", attached->getId(), attached->getLeaderId(), command);
+    ATCounters::add(counters.coalescedCommands);
+  }
+  return attached;
+}
+
+// Called with mutex held once the query `leaderId` completed.
+template <typename Config>
+void BasicAsyncATHandler<Config>::resolveAttached(uint32_t leaderId, const ATResponse& response) {
+  for (auto& promise : pendingPromises) {
+    if (promise->getLeaderId() != leaderId || promise->isCompleted()) { continue; }
+    promise->resolveWith(response);
+    responseBytes += promise->getResponse()->getRetainedBytes();
+  }
+  if (responseBytes > peakResponseBytes) { peakResponseBytes = responseBytes; }
+}
+
+template <typename Config>
+bool BasicAsyncATHandler<Config>::cacheCommand(
+    const char* command, uint32_t ttlMs, const char* invalidatedBy) {
+  if (!mutex || !mutex.take(pdMS_TO_TICKS(100))) { return false; }
+  bool added = cache.add(command, ttlMs, invalidatedBy);
+  mutex.give();
+  return added;
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::invalidateCache(const char* command) {
+  if (!mutex || !mutex.take(pdMS_TO_TICKS(100))) { return; }
+  cache.invalidate(command);
+  mutex.give();
+}
+
+// Shared by the sendSync() overloads; the full response is only built when asked for.
+template <typename Config>
+bool BasicAsyncATHandler<Config>::sendAndWait(
+    const char* command, String* response, uint32_t timeout) {
+  ATPromise* promise = sendCommand(command);
+  if (!promise) { return false; }
+  lock();
+
+  promise->timeout(timeout);
+  AT_LOGI("Waiting for promise [%u] with timeout %u ms", promise->getId(), timeout);
+  bool success = promise->wait();
+  AT_LOGI("Promise [%u] wait finished. Success: %s", promise->getId(), success ? "TRUE" : "FALSE");
+
+  if (!success && mutex.take(pdMS_TO_TICKS(100))) {
+    stats.recordTimeout(promise->getStatsSlot());
+    AT_TRACE(trace, ATTraceEventType::PROMISE_TIMEOUT, promise->getId());
+    mutex.give();
+  }
+
+  if (success) {
+    if (response) { *response = promise->getResponse()->getFullResponse(); }
+    success = promise->getResponse()->isSuccess();
+  } else if (response) {
+    *response = "";
+  }
+
+  auto completedPromise = popCompletedPromise(promise->getId());
+  if (!completedPromise) {
+    AT_LOGW("Failed to pop completed promise [%u] from list", promise->getId());
+  }
+  unlock();
+  return success;
+}
+
+template <typename Config>
+ATPromisePtr BasicAsyncATHandler<Config>::popCompletedPromise(uint32_t commandId) {
+  ATPromisePtr promise;
+  if (mutex.take(pdMS_TO_TICKS(100))) {
+    auto it = std::find_if(
+        pendingPromises.begin(), pendingPromises.end(),
+        [commandId](const ATPromisePtr& p) { return p && p->getId() == commandId; });
+    if (it != pendingPromises.end()) {
+      promise = std::move(*it);
+      pendingPromises.erase(it);
+      releaseSlot();
+      size_t retained = promise->getResponse()->getRetainedBytes();
+      responseBytes = retained < responseBytes ? responseBytes - retained : 0;
+      if (kCoalesceQueries && !promise->isCompleted()) {
+        // Popped before its response arrived: the first attached query takes over the exchange.
+        uint32_t successor = 0;
+        for (auto& attached : pendingPromises) {
+          if (attached->getLeaderId() != commandId) { continue; }
+          attached->attachTo(successor);
+          if (!successor) { successor = attached->getId(); }
+        }
+      }
+      AT_LOGD("Popped promise with ID: %u", commandId);
+    }
+    mutex.give();
+    AT_LOGD("Promise list size after pop: %zu", pendingPromises.size());
+  }
+  return promise;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ATLock/ATLock.h"
+#include "ATMqtt/ATMqttMessage.h"
+#include "ATStorage/ATStorage.settings.h"
+#include "freertos/FreeRTOS.h"
+
+struct AsyncATHandlerConfig {
+  const char* taskName = "AT_Reader";
+  uint32_t stackSize = 4096;  // Stack depth as passed to xTaskCreatePinnedToCore
+  UBaseType_t priority = 2;
+  BaseType_t coreId = 1;
+
+  // Optional caller-owned storage for the reader task. When both are set the task is created
+  // with xTaskCreateStaticPinnedToCore and begin() does not allocate from the heap; begin()
+  // fails when only one is set. stackBuffer must hold stackSize elements and outlive the handler.
+  StackType_t* stackBuffer = nullptr;
+  StaticTask_t* taskBuffer = nullptr;
+
+  // Reader polling for streams that cannot signal arriving data. The reader polls every
+  // pollIntervalMs while commands are pending or data arrived within activeHoldMs, then doubles
+  // its sleep per idle poll up to maxPollIntervalMs so tickless idle can kick in. sendCommand()
+  // wakes it early. Keep the ceiling short enough for the UART RX buffer to hold a URC burst.
+  // The default ceiling equals the interval, i.e. fixed-rate polling.
+  uint32_t pollIntervalMs = 10;
+  uint32_t maxPollIntervalMs = 10;
+  uint32_t activeHoldMs = 100;
+};
+
+// Lines starting with one of these prefixes are treated as unsolicited result codes.
+struct ATDefaultURCs {
+  static constexpr const char* prefixes[] = {
+      "+CMT:",       // SMS notification
+      "+CMTI:",      // SMS index notification
+      "+CLIP:",      // Calling line identification
+      "+CREG:",      // Network registration (when unsolicited)
+      "+CGREG:",     // GPRS registration (when unsolicited)
+      "+CEREG:",     // EPS registration (when unsolicited)
+      "+QIURC:",     // Quectel socket URC
+      "+QMTRECV:",   // Quectel MQTT receive URC
+      "+QIOPEN:",    // Quectel socket open result
+      "+QIRD:",      // Quectel socket read
+      "+QMTSTAT:",   // Quectel MQTT status URC
+      "+QSSLOPEN:",  // Quectel SSL socket open result
+      "+QSSLURC:",   // Quectel SSL socket URC
+      "+QSSLRECV:",  // Quectel SSL receive
+      "+QICLOSE",    // Quectel socket close
+  };
+};
+
+// Responses announcing a binary data block: a line "<prefix> <length>" followed by exactly
+// <length> raw bytes, which may contain "\r\n", "OK" or NUL. The bytes are passed through
+// verbatim, see BasicAsyncATHandler::receiveData(). Lines with more fields, e.g. the
+// "+QIRD: <total>,<read>,<unread>" query form, are handled as usual. A block is only taken by a
+// pending command answering with the header's prefix (see ATCommandInfo) and dropped otherwise.
+struct ATDefaultDataHeaders {
+  static constexpr const char* prefixes[] = {
+      "+QIRD:",      // Quectel socket read
+      "+QSSLRECV:",  // Quectel SSL socket read
+  };
+};
+
+// URCs whose content runs over several lines. The lines following one that starts with `prefix`
+// are appended to it, "\r\n" included, and the whole is dispatched as one URC once it has
+// `lines` more lines, or once isComplete() accepts it when set. When set, length() gives the
+// bytes the whole frame spans from its first line, 0 if that line carries no byte count. They
+// never reach a pending command.
+//
+// A frame is bounded by URCFrameTimeoutMs; the lines collected by then are dispatched as they
+// are and counted in ATCounterSnapshot::cutFrames. A frame without a byte count cannot hold a
+// final result code (OK, ERROR, ...), which closes it early the same way; one with a count ends
+// only with its bytes. A frame that outgrows LineCapacity is dropped: its remaining bytes or
+// lines are skipped when known, otherwise everything up to the next final result code, which
+// then fails its command since lines of the answer may be gone.
+struct ATURCFrame {
+  const char* prefix;
+  uint8_t lines;
+  bool (*isComplete)(const char* line, size_t length);
+  size_t (*length)(const char* line, size_t length);
+};
+
+struct ATDefaultURCFraming {
+  static constexpr ATURCFrame frames[] = {
+      {"+CMT:", 1, nullptr, nullptr},  // SMS header, then text or PDU
+      {ATMqttMessage::kPrefix, 0, &ATMqttMessage::isComplete,
+       &ATMqttMessage::frameLength},  // Payload may contain "\r\n"
+  };
+};
+
+// Commands whose information lines do not start with their own name. A command "AT+NAME..."
+// (also '#', '$', '^' or '%' instead of '+') is otherwise expected to answer "+NAME: ...", and
+// such lines go to the oldest command in flight that expects them rather than simply the oldest.
+// `command` is the name up to '=' or '?'; a null responsePrefix means the answer has no prefix.
+struct ATCommandInfo {
+  const char* command;
+  const char* responsePrefix;
+};
+
+struct ATDefaultCommands {
+  static constexpr ATCommandInfo commands[] = {
+      {"AT+CGSN", nullptr},  // Bare IMEI
+      {"AT+GSN", nullptr},   // Bare IMEI
+      {"AT+CIMI", nullptr},  // Bare IMSI
+      {"AT+QGMR", nullptr},  // Bare firmware revision
+  };
+};
+
+// Idempotent commands without a trailing '?' that CoalesceQueries may merge, matched against the
+// whole command text. Needs no cache.
+struct ATDefaultCoalescedCommands {
+  static constexpr const char* commands[] = {
+      "AT+CSQ",      // Signal quality
+      "AT+CBC",      // Battery charge
+      "AT+QCSQ",     // Extended signal quality
+      "AT+QNWINFO",  // Network information
+  };
+};
+
+// What sendCommand() does when MaxPendingCommands commands are already in flight. Commands on
+// the wire cannot be recalled, so every policy acts on the incoming command.
+enum class ATAdmissionPolicy : uint8_t {
+  FAIL_FAST,          // Reject with ATSendResult::QUEUE_FULL
+  BLOCK,              // Wait up to AdmissionTimeoutMs for a slot, then ADMISSION_TIMEOUT
+  DROP_LOW_PRIORITY,  // Like FAIL_FAST, and reject LOW commands (DROPPED) once only
+                      // ReservedSlots slots are left
+};
+
+enum class ATPriority : uint8_t {
+  LOW,     // Telemetry and other background traffic
+  NORMAL,  // Interactive commands; the default
+};
+
+// Outcome of sendCommand(), reported through its optional out parameter.
+enum class ATSendResult : uint8_t {
+  SENT,
+  NOT_STARTED,        // begin() not called, or a null command
+  QUEUE_FULL,         // MaxPendingCommands in flight
+  DROPPED,            // LOW priority command shed under DROP_LOW_PRIORITY
+  ADMISSION_TIMEOUT,  // No slot freed within AdmissionTimeoutMs under BLOCK
+  BUSY,               // Timed out waiting for the promise list mutex
+  NO_MEMORY,          // No promise could be created
+};
+
+// Compile-time parameters of BasicAsyncATHandler. Derive from it and redeclare the members to
+// change, e.g. `struct SmallConfig : DefaultATHandlerConfig { static constexpr size_t
+// LineCapacity = 128; };`.
+struct DefaultATHandlerConfig {
+  // Longest line kept, excluding the terminating "\r\n". Longer lines are dropped and counted
+  // in ATCounterSnapshot::lineOverflows.
+  static constexpr size_t LineCapacity = 512;
+
+  // Commands that may be in flight (sent and not yet popped) at once; Admission decides what
+  // sendCommand() does beyond it. 0 means unbounded. With AT_STATIC_ALLOCATION it is also the
+  // promise pool size.
+  static constexpr size_t MaxPendingCommands = AT_STATIC_ALLOCATION ? 8 : 0;
+
+  // Behaviour at the MaxPendingCommands limit, see ATAdmissionPolicy.
+  static constexpr ATAdmissionPolicy Admission = ATAdmissionPolicy::FAIL_FAST;
+  static constexpr uint32_t AdmissionTimeoutMs = 1000;
+  // Slots only NORMAL commands may take under DROP_LOW_PRIORITY, which needs a MaxPendingCommands
+  // above it.
+  static constexpr size_t ReservedSlots = 1;
+
+  // Lines stored per ATResponse. Past the limit further intermediate lines are dropped but the
+  // final result is always kept, so 1 stores only the result code. 0 means unbounded.
+  static constexpr size_t MaxResponseLines = 0;
+
+  // Query commands cacheCommand() can register. 0 compiles the response cache out.
+  static constexpr size_t MaxCachedCommands = 0;
+
+  // Attach a query to an identical one still in flight instead of sending it again. Applies to
+  // read commands (ending in '?'), to CoalescedCommands and to commands registered with
+  // cacheCommand().
+  static constexpr bool CoalesceQueries = false;
+
+  // Callbacks addURCListener() can register besides onURC().
+  static constexpr size_t MaxURCListeners = 4;
+
+  // Longest a URCFraming frame stays open after its first line without completing.
+  static constexpr uint32_t URCFrameTimeoutMs = 500;
+
+  // Wait used by sendSync() and ATPromise::wait() when no timeout is given.
+  static constexpr uint32_t DefaultTimeoutMs = 5000;
+
+  using URCs = ATDefaultURCs;
+  using DataHeaders = ATDefaultDataHeaders;
+  using URCFraming = ATDefaultURCFraming;
+  using Commands = ATDefaultCommands;
+  using CoalescedCommands = ATDefaultCoalescedCommands;
+  using Lock = ATMutexLock;  // See ATLock.h
+};
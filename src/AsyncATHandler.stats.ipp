@@ -0,0 +1,53 @@
+template <typename Config>
+size_t BasicAsyncATHandler<Config>::getStats(ATCommandStats* out, size_t maxEntries) {
+  if (!out || !mutex) { return 0; }
+  if (!mutex.take(pdMS_TO_TICKS(100))) {
+    AT_LOGE("Failed to acquire mutex for getStats");
+    return 0;
+  }
+  size_t count = 0;
+  while (count < maxEntries && stats.get(count, out[count])) { count++; }
+  mutex.give();
+  return count;
+}
+
+template <typename Config>
+bool BasicAsyncATHandler<Config>::getStats(const char* prefix, ATCommandStats& out) {
+  if (!prefix || !mutex) { return false; }
+  if (!mutex.take(pdMS_TO_TICKS(100))) {
+    AT_LOGE("Failed to acquire mutex for getStats");
+    return false;
+  }
+  int slot = stats.find(prefix);
+  bool found = slot >= 0 && stats.get(slot, out);
+  mutex.give();
+  return found;
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::resetStats() {
+  if (!mutex) { return; }
+  if (mutex.take(pdMS_TO_TICKS(100))) {
+    stats.reset();
+    mutex.give();
+  }
+}
+
+template <typename Config>
+ATMemoryStats BasicAsyncATHandler<Config>::getMemoryStats() {
+  ATMemoryStats memory;
+  memory.peakLineLength = peakLineLength.load(std::memory_order_relaxed);
+#if INCLUDE_uxTaskGetStackHighWaterMark
+  if (readerTask) { memory.readerStackHighWaterMark = uxTaskGetStackHighWaterMark(readerTask); }
+#endif
+  if (!mutex || !mutex.take(pdMS_TO_TICKS(100))) {
+    AT_LOGE("Failed to acquire mutex for getMemoryStats");
+    return memory;
+  }
+  memory.pendingPromises = pendingPromises.size();
+  memory.peakPendingPromises = peakPendingPromises;
+  memory.responseBytes = responseBytes;
+  memory.peakResponseBytes = peakResponseBytes;
+  mutex.give();
+  return memory;
+}
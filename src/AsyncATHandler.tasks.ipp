@@ -0,0 +1,387 @@
+template <typename Config>
+void BasicAsyncATHandler<Config>::readerTaskFunction(void* parameter) {
+  auto* handler = static_cast<BasicAsyncATHandler*>(parameter);
+  AT_LOGI("Reader task started.");
+  const AsyncATHandlerConfig& config = handler->config;
+  const TickType_t minInterval = std::max<TickType_t>(1, pdMS_TO_TICKS(config.pollIntervalMs));
+  const TickType_t maxInterval =
+      std::max<TickType_t>(minInterval, pdMS_TO_TICKS(config.maxPollIntervalMs));
+  const TickType_t hold = pdMS_TO_TICKS(config.activeHoldMs);
+  const TickType_t window = pdMS_TO_TICKS(1000);
+
+  TickType_t interval = minInterval;
+  TickType_t lastActivity = xTaskGetTickCount();
+  TickType_t windowStart = lastActivity;
+  uint32_t windowWakeups = 0;
+  while (true) {
+    ATCounters::add(handler->counters.readerWakeups);
+    TickType_t now = xTaskGetTickCount();
+    if (handler->processIncomingData() || handler->inFlight.load(std::memory_order_relaxed)) {
+      lastActivity = now;
+    }
+    if (now - lastActivity < hold) {
+      interval = minInterval;
+    } else {
+      interval = std::min<TickType_t>(interval * 2, maxInterval);
+    }
+    handler->pollInterval.store(interval, std::memory_order_relaxed);
+
+    windowWakeups++;
+    if (now - windowStart >= window) {
+      uint32_t elapsedMs = (now - windowStart) * portTICK_PERIOD_MS;
+      handler->milliWakeupsPerSecond.store(
+          static_cast<uint32_t>(uint64_t(windowWakeups) * 1000000 / elapsedMs),
+          std::memory_order_relaxed);
+      windowStart = now;
+      windowWakeups = 0;
+    }
+
+    // Sleeps like vTaskDelay() unless sendCommand() notifies the task.
+    ulTaskNotifyTake(pdTRUE, interval);
+  }
+}
+
+template <typename Config>
+uint32_t BasicAsyncATHandler<Config>::processIncomingData() {
+  if ((frameLineStart || frameSkipBytes || frameDiscarding) &&
+      millis() - frameOpenedAt >= Config::URCFrameTimeoutMs) {
+    closeFrame();
+  }
+  // The command a line was held for ended without a final result code, e.g. by its timeout.
+  if (heldFor && !isPending(heldFor)) { releaseHeldLine(nullptr); }
+  if (!stream || !stream->available()) { return 0; }
+
+  uint32_t received = 0;
+  while (stream->available()) {
+    char c = static_cast<char>(stream->read());
+    received++;
+    if (frameSkipBytes) {
+      // The rest of a frame too long to keep, its length known from the first line.
+      frameSkipBytes--;
+      continue;
+    }
+    lineBuffer[lineLength++] = c;
+
+    if (blockRemaining) {
+      // Inside a binary data block: pass the bytes through without looking for line ends.
+      blockRemaining--;
+      if (!blockRemaining || lineLength == kBlockChunk) {
+        deliverBlockChunk();
+        lineLength = 0;
+      }
+      continue;
+    }
+
+    if (isLineComplete()) {
+      if (frameDiscarding) {
+        // Rest of a frame too long to keep: a known number of lines, else up to a final result
+        // code, which goes to its command as a failure.
+        ResponseType type = frameSkipLines ? ResponseType::INTERMEDIATE_DATA
+                                           : classifyLine(lineBuffer, lineLength);
+        if (type == ResponseType::INTERMEDIATE_DATA || type == ResponseType::UNSOLICITED) {
+          if (frameSkipLines) { frameDiscarding = --frameSkipLines > 0; }
+          lineLength = 0;
+        } else {
+          frameDiscarding = false;
+          dispatchLine(lineLength, true);
+        }
+      } else if (isFrameOpen()) {
+        continueFrame();
+      } else {
+        frameLineStart = 0;
+        dispatchLine(lineLength);
+      }
+    }
+
+    if (lineLength > kLineCapacity) {
+      notePeakLineLength(lineLength);
+      AT_TRACE(trace, ATTraceEventType::LINE_OVERFLOW, 0, lineLength);
+      if (frameLineStart) {
+        skipFrame();
+      } else {
+        AT_LOGW("Line buffer overflow, clearing.");
+      }
+      lineLength = 0;
+      ATCounters::add(counters.lineOverflows);
+    }
+  }
+  ATCounters::add(counters.rxBytes, received);
+  return received;
+}
+
+// Processes the first `length` bytes of lineBuffer as one line and keeps the bytes after them.
+template <typename Config>
+void BasicAsyncATHandler<Config>::dispatchLine(size_t length, bool answerCut) {
+  char next = lineBuffer[length];
+  lineBuffer[length] = '\0';
+  notePeakLineLength(length);
+  AT_LOGD("Processing line: '%s'", lineBuffer);
+  AT_TRACE(trace, ATTraceEventType::LINE_FRAMED, 0, length);
+  processCompleteLine(lineBuffer, length, answerCut);
+  lineBuffer[length] = next;
+  lineLength -= length;
+  memmove(lineBuffer, lineBuffer + length, lineLength);
+}
+
+// A line of an open Config::URCFraming frame has ended. Without a byte count, a final result
+// code cannot belong to the URC, so it closes the frame and is processed on its own; a counted
+// payload may hold "OK" lines, so only the count ends that frame. Otherwise the frame waits for
+// its next line.
+template <typename Config>
+void BasicAsyncATHandler<Config>::continueFrame() {
+  if (!frameLineStart) {
+    const ATURCFrame* frame = bufferedFrame();
+    frameOpenedAt = millis();
+    frameBytes = frame && frame->length ? frame->length(lineBuffer, lineLength) : 0;
+  } else if (!frameBytes) {
+    ResponseType type = classifyLine(lineBuffer + frameLineStart, lineLength - frameLineStart);
+    if (type != ResponseType::INTERMEDIATE_DATA && type != ResponseType::UNSOLICITED) {
+      closeFrame();
+      dispatchLine(lineLength);
+      return;
+    }
+  }
+  frameLineStart = lineLength;
+}
+
+// The open frame outgrew lineBuffer while its current line was collected. Its remaining bytes
+// are skipped when the first line gave them, its remaining lines for a frame of fixed length;
+// other frames are dropped up to the next final result code.
+template <typename Config>
+void BasicAsyncATHandler<Config>::skipFrame() {
+  AT_LOGW("Multi-line URC outgrew the line buffer, dropping it");
+  ATCounters::add(counters.cutFrames);
+  const ATURCFrame* frame = bufferedFrame();
+  if (frameBytes) {
+    frameSkipBytes = frameBytes > lineLength ? frameBytes - lineLength : 0;
+  } else {
+    // The line being collected still has its end to come.
+    frameSkipLines = frame && !frame->isComplete ? frame->lines + 1 - bufferedLineEnds() : 0;
+    frameDiscarding = true;
+  }
+  frameLineStart = 0;
+  frameBytes = 0;
+}
+
+// Ends an open frame before it is complete: its finished lines are dispatched as one URC as
+// they are, the bytes after them stay in lineBuffer.
+template <typename Config>
+void BasicAsyncATHandler<Config>::closeFrame() {
+  if (frameLineStart) {
+    AT_LOGW("Multi-line URC cut short after %u bytes", static_cast<unsigned>(frameLineStart));
+    ATCounters::add(counters.cutFrames);
+    dispatchLine(frameLineStart);
+  }
+  frameLineStart = 0;
+  frameBytes = 0;
+  frameSkipBytes = 0;
+  frameSkipLines = 0;
+  frameDiscarding = false;
+}
+
+// `answerCut` marks a final result code after lines were dropped with an oversized frame; some
+// of them may have belonged to the answer, so the command fails rather than succeeding without.
+template <typename Config>
+void BasicAsyncATHandler<Config>::processCompleteLine(
+    const char* line, size_t length, bool answerCut) {
+  if (startDataBlock(line, length)) { return; }
+
+  ResponseType type = classifyLine(line, length);
+  if (answerCut && type != ResponseType::INTERMEDIATE_DATA && type != ResponseType::UNSOLICITED) {
+    AT_LOGW("Failing the answer to this result, lines of it were dropped with a frame");
+    type = ResponseType::FINAL_ERROR;
+  }
+  if (type == ResponseType::UNSOLICITED) {
+    if (ATPromise* query = findPromiseByPrefix(line)) {
+      holdQueryLine(query->getId(), line, length);
+      return;
+    }
+  }
+  counters.countLine(type);
+  AT_TRACE(trace, ATTraceEventType::LINE_CLASSIFIED, 0, 0, static_cast<uint8_t>(type));
+
+  if (type == ResponseType::UNSOLICITED) {
+    handleUnsolicitedResponse(line, length);
+    return;
+  }
+
+  ATPromise* promise = findPromiseForResponse(line, length);
+  if (heldFor && type != ResponseType::INTERMEDIATE_DATA) {
+    releaseHeldLine(promise && type == ResponseType::FINAL_OK ? promise : nullptr);
+  }
+  if (promise) {
+    addLineToPromise(promise, line, length, type);
+  } else {
+    ATCounters::add(counters.orphanLines);
+    AT_TRACE(trace, ATTraceEventType::LINE_ORPHANED);
+  }
+}
+
+// Read commands such as AT+CEREG? answer with the prefix of a URC, "+CEREG: 2,1" next to the
+// URC "+CEREG: 5", and either may arrive while the command is pending. The answer is a single
+// line right before the final result code, so such a line is held: a later line with the same
+// prefix shows it was a URC, the command's OK that it was the answer.
+template <typename Config>
+void BasicAsyncATHandler<Config>::holdQueryLine(
+    uint32_t queryId, const char* line, size_t length) {
+  releaseHeldLine(nullptr);
+  heldLine = ATLineString(line, length, memoryResource);
+  heldFor = queryId;
+}
+
+// Hands the held line to `answered` when it is the command it was held for, else to the URC
+// consumers.
+template <typename Config>
+void BasicAsyncATHandler<Config>::releaseHeldLine(ATPromise* answered) {
+  if (!heldFor) { return; }
+  ATLineString line = std::move(heldLine);
+  uint32_t queryId = heldFor;
+  heldLine = ATLineString();
+  heldFor = 0;
+  if (answered && answered->getId() == queryId) {
+    counters.countLine(ResponseType::INTERMEDIATE_DATA);
+    addLineToPromise(answered, line.c_str(), line.length(), ResponseType::INTERMEDIATE_DATA);
+  } else {
+    counters.countLine(ResponseType::UNSOLICITED);
+    handleUnsolicitedResponse(line.c_str(), line.length());
+  }
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::addLineToPromise(
+    ATPromise* promise, const char* line, size_t length, ResponseType type) {
+  if (!mutex) { return; }
+  ResponseLine responseLine;
+  responseLine.content = ATLineString(line, length, memoryResource);
+  responseLine.type = type;
+  responseLine.timestamp = micros();
+  responseLine.commandId = promise->getId();
+
+  if (!mutex.take(pdMS_TO_TICKS(10))) {
+    AT_LOGE("Failed to acquire mutex for adding response");
+    ATCounters::add(counters.routeMutexTimeouts);
+    return;
+  }
+  bool wasSettled = promise->isSettled();
+  ATResponse* response = promise->getResponse();
+  bool wasCompleted = response->isCompleted();
+  size_t retainedBefore = response->getRetainedBytes();
+  bool retain = !kMaxResponseLines || response->getLineCount() + 1 < kMaxResponseLines;
+  promise->addResponseLine(responseLine, retain);
+  responseBytes += response->getRetainedBytes() - retainedBefore;
+  if (responseBytes > peakResponseBytes) { peakResponseBytes = responseBytes; }
+  AT_TRACE(trace, ATTraceEventType::LINE_ROUTED, promise->getId());
+  if (!wasCompleted && response->isSuccess() && promise->getCacheSlot() >= 0) {
+    cache.store(promise->getCacheSlot(), *response, millis());
+  }
+  if (kCoalesceQueries && !wasCompleted && response->isCompleted()) {
+    resolveAttached(promise->getId(), *response);
+  }
+  // A data prompt only settles the first half of a sendWithPayload() exchange.
+  if (!wasSettled && promise->isSettled() && line[0] != '>') {
+    bool error = response->isCompleted() && !response->isSuccess();
+    stats.recordCompletion(
+        promise->getStatsSlot(), promise->getFirstLineLatency(), promise->getFinalLatency(),
+        error);
+    AT_TRACE(trace, ATTraceEventType::PROMISE_SETTLED, promise->getId(), 0, !error);
+  }
+  mutex.give();
+}
+
+// A "<prefix> <length>" line from Config::DataHeaders starts a binary block of <length> bytes,
+// which processIncomingData() then passes through verbatim. The block goes to the oldest pending
+// command answering with that prefix, e.g. AT+QIRD for "+QIRD: 6"; without one it is dropped,
+// so an unrelated command cannot swallow the bytes.
+template <typename Config>
+bool BasicAsyncATHandler<Config>::startDataBlock(const char* line, size_t length) {
+  const char* cursor = nullptr;
+  for (const char* prefix : Config::DataHeaders::prefixes) {
+    size_t prefixLength = strlen(prefix);
+    if (prefixLength <= length && memcmp(line, prefix, prefixLength) == 0) {
+      cursor = line + prefixLength;
+      break;
+    }
+  }
+  if (!cursor) { return false; }
+
+  const char* end = line + length;
+  while (cursor < end && *cursor == ' ') { cursor++; }
+  size_t blockLength = 0;
+  const char* digits = cursor;
+  while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+    blockLength = blockLength * 10 + (*cursor++ - '0');
+  }
+  if (cursor == digits || end - cursor != 2 || memcmp(cursor, "\r\n", 2) != 0) { return false; }
+
+  ATPromise* promise = findPromiseByPrefix(line, false);
+  if (!promise) {
+    AT_LOGW("Dropping %u byte data block no command asked for", static_cast<unsigned>(blockLength));
+    ATCounters::add(counters.orphanLines);
+    blockRemaining = blockLength;
+    blockPromiseId = 0;
+    return true;
+  }
+
+  counters.countLine(ResponseType::INTERMEDIATE_DATA);
+  addLineToPromise(promise, line, length, ResponseType::INTERMEDIATE_DATA);
+  blockRemaining = blockLength;
+  blockPromiseId = promise->getId();
+  AT_LOGD("Data block of %u bytes for [%u]", static_cast<unsigned>(blockLength), blockPromiseId);
+  return true;
+}
+
+// Hands the block bytes collected in lineBuffer to the promise's data sink, or stores them as a
+// response line when it has none.
+template <typename Config>
+void BasicAsyncATHandler<Config>::deliverBlockChunk() {
+  if (!mutex) { return; }
+  if (!mutex.take(pdMS_TO_TICKS(10))) {
+    ATCounters::add(counters.routeMutexTimeouts);
+    return;
+  }
+  ATPromise* promise = nullptr;
+  for (auto& pending : pendingPromises) {
+    if (blockPromiseId && pending && pending->getId() == blockPromiseId &&
+        !pending->isCompleted()) {
+      promise = pending.get();
+      break;
+    }
+  }
+  if (promise && promise->getDataSink()) {
+    promise->getDataSink()(reinterpret_cast<const uint8_t*>(lineBuffer), lineLength);
+    mutex.give();
+    return;
+  }
+  mutex.give();
+  if (!promise) {
+    ATCounters::add(counters.droppedBlockBytes, lineLength);
+    return;
+  }
+  addLineToPromise(promise, lineBuffer, lineLength, ResponseType::INTERMEDIATE_DATA);
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::handleUnsolicitedResponse(const char* line, size_t length) {
+  bool listened = urcListenerCount.load(std::memory_order_relaxed) > 0;
+  if (!urcCallback && !listened) {
+    if (kMaxCachedCommands && mutex.take(pdMS_TO_TICKS(10))) {
+      cache.invalidateByURC(line);
+      mutex.give();
+    }
+    return;
+  }
+
+  // Listeners read the line in place; only the callback gets a copy.
+  if ((kMaxCachedCommands || listened) && mutex.take(pdMS_TO_TICKS(10))) {
+    cache.invalidateByURC(line);
+    for (size_t i = 0; listened && i < kMaxURCListeners; i++) {
+      if (urcListeners[i]) { urcListeners[i](line, length); }
+    }
+    mutex.give();
+  }
+  if (urcCallback) {
+    ATCounters::add(counters.urcsDispatched);
+    AT_TRACE(trace, ATTraceEventType::URC_DISPATCHED, 0, length);
+    urcCallback(ATLineString(line, length, memoryResource));
+  }
+}
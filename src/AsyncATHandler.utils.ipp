@@ -0,0 +1,202 @@
+template <typename Config>
+bool BasicAsyncATHandler<Config>::isLineComplete() {
+  if (lineBuffer[0] == '>') {
+    // Data prompt, treat as a complete line
+    lineBuffer[1] = '\r';
+    lineBuffer[2] = '\n';
+    lineLength = 3;
+    return true;
+  }
+  return lineLength >= 2 && lineBuffer[lineLength - 2] == '\r' &&
+         lineBuffer[lineLength - 1] == '\n';
+}
+
+// The Config::URCFraming frame whose prefix lineBuffer starts with, or null.
+template <typename Config>
+const ATURCFrame* BasicAsyncATHandler<Config>::bufferedFrame() {
+  for (const ATURCFrame& frame : Config::URCFraming::frames) {
+    size_t prefixLength = strlen(frame.prefix);
+    if (prefixLength <= lineLength && memcmp(lineBuffer, frame.prefix, prefixLength) == 0) {
+      return &frame;
+    }
+  }
+  return nullptr;
+}
+
+template <typename Config>
+size_t BasicAsyncATHandler<Config>::bufferedLineEnds() {
+  size_t lines = 0;
+  for (size_t i = 1; i < lineLength; i++) {
+    if (lineBuffer[i - 1] == '\r' && lineBuffer[i] == '\n') { lines++; }
+  }
+  return lines;
+}
+
+// True while lineBuffer holds the start of a Config::URCFraming frame that needs more lines.
+template <typename Config>
+bool BasicAsyncATHandler<Config>::isFrameOpen() {
+  const ATURCFrame* frame = bufferedFrame();
+  if (!frame) { return false; }
+  if (frame->isComplete) { return !frame->isComplete(lineBuffer, lineLength); }
+  return bufferedLineEnds() <= frame->lines;
+}
+
+namespace ATClassifyDetail {
+
+inline bool isPadding(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+inline bool equals(const char* text, size_t length, const char* literal) {
+  return strlen(literal) == length && memcmp(text, literal, length) == 0;
+}
+
+inline bool isPrefixMark(char c) {
+  return c == '+' || c == '#' || c == '$' || c == '^' || c == '%';
+}
+
+// FNV-1a of `length` bytes and a closing ':', never 0, so "AT+CSQ" and "+CSQ: 9,99" agree.
+inline uint32_t prefixKey(const char* text, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) { hash = (hash ^ static_cast<uint8_t>(text[i])) * 16777619u; }
+  hash = (hash ^ static_cast<uint8_t>(':')) * 16777619u;
+  return hash ? hash : 1;
+}
+
+// Key of a line's "+NAME:" prefix, 0 when it has none. `prefixLength` receives the length of
+// "+NAME".
+inline uint32_t lineKey(const char* line, size_t& prefixLength) {
+  if (!isPrefixMark(line[0])) { return 0; }
+  size_t length = 1;
+  while (line[length] && line[length] != ':') {
+    if (isPadding(line[length]) || length == 32) { return 0; }
+    length++;
+  }
+  if (line[length] != ':') { return 0; }
+  prefixLength = length;
+  return prefixKey(line, length);
+}
+
+inline bool startsWith(const char* text, size_t length, const char* prefix) {
+  size_t prefixLength = strlen(prefix);
+  return prefixLength <= length && memcmp(text, prefix, prefixLength) == 0;
+}
+
+}  // namespace ATClassifyDetail
+
+template <typename Config>
+ResponseType BasicAsyncATHandler<Config>::classifyLine(const char* line, size_t length) {
+  using namespace ATClassifyDetail;
+
+  // Compare against the line without surrounding whitespace, in place.
+  while (length && isPadding(*line)) {
+    line++;
+    length--;
+  }
+  while (length && isPadding(line[length - 1])) { length--; }
+
+  // Check for final responses first
+  if (equals(line, length, "OK")) return ResponseType::FINAL_OK;
+  if (equals(line, length, "ERROR")) return ResponseType::FINAL_ERROR;
+  if (startsWith(line, length, "+CME ERROR:")) return ResponseType::FINAL_CME_ERROR;
+  // Results of a data send after the '>' prompt, e.g. AT+QISEND.
+  if (equals(line, length, "SEND OK")) return ResponseType::FINAL_OK;
+  if (equals(line, length, "SEND FAIL")) return ResponseType::FINAL_ERROR;
+
+  // Check for explicit URCs.
+  for (const char* prefix : Config::URCs::prefixes) {
+    if (startsWith(line, length, prefix)) { return ResponseType::UNSOLICITED; }
+  }
+
+  // Default: intermediate data
+  return ResponseType::INTERMEDIATE_DATA;
+}
+
+template <typename Config>
+void BasicAsyncATHandler<Config>::setResponsePrefix(ATPromise& promise, const char* command) {
+  using namespace ATClassifyDetail;
+  if ((command[0] != 'A' && command[0] != 'a') || (command[1] != 'T' && command[1] != 't') ||
+      !isPrefixMark(command[2])) {
+    return;
+  }
+  size_t length = 2;
+  while (command[length] && command[length] != '=' && command[length] != '?' &&
+         command[length] != ';') {
+    length++;
+  }
+  size_t commandLength = length + strlen(command + length);
+  bool query = command[commandLength - 1] == '?';
+  for (const ATCommandInfo& info : Config::Commands::commands) {
+    if (strlen(info.command) == length && memcmp(info.command, command, length) == 0) {
+      size_t prefixLength = 0;
+      uint32_t key = info.responsePrefix ? lineKey(info.responsePrefix, prefixLength) : 0;
+      promise.setResponsePrefix(info.responsePrefix, prefixLength, key, query);
+      return;
+    }
+  }
+  promise.setResponsePrefix(command + 2, length - 2, prefixKey(command + 2, length - 2), query);
+}
+
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::findPromiseForResponse(const char* line, size_t length) {
+  if (pendingPromises.empty()) return nullptr;
+
+  // Promises attached to a coalesced query are resolved from it, see resolveAttached().
+
+  // Find the promise that is explicitly waiting for this line first
+  for (auto& promise : pendingPromises) {
+    if (promise && !promise->isCompleted() && !promise->getLeaderId()) {
+      if (promise->matchesExpected(line, length)) { return promise.get(); }
+    }
+  }
+
+  // Then the oldest one whose command answers with the line's prefix, e.g. "+CSQ:" for AT+CSQ.
+  // A linear scan comparing keys, then text; other lines keep the order of the modem's answers.
+  size_t prefixLength = 0;
+  if (uint32_t key = ATClassifyDetail::lineKey(line, prefixLength)) {
+    for (auto& promise : pendingPromises) {
+      if (promise && !promise->isCompleted() && !promise->getLeaderId() &&
+          promise->answersWith(line, prefixLength, key)) {
+        ATCounters::add(counters.prefixRoutedLines);
+        return promise.get();
+      }
+    }
+  }
+
+  // Fallback: if no specific match, find the oldest incomplete promise
+  for (auto& promise : pendingPromises) {
+    if (promise && !promise->isCompleted() && !promise->getLeaderId()) { return promise.get(); }
+  }
+  return nullptr;
+}
+
+template <typename Config>
+bool BasicAsyncATHandler<Config>::isPending(uint32_t id) {
+  if (!mutex.take(pdMS_TO_TICKS(10))) { return true; }
+  bool pending = false;
+  for (auto& promise : pendingPromises) {
+    if (promise && promise->getId() == id && !promise->isCompleted()) {
+      pending = true;
+      break;
+    }
+  }
+  mutex.give();
+  return pending;
+}
+
+// The oldest pending command that answers with the prefix of `line`; with queriesOnly, only
+// read and test commands.
+template <typename Config>
+ATPromise* BasicAsyncATHandler<Config>::findPromiseByPrefix(const char* line, bool queriesOnly) {
+  size_t prefixLength = 0;
+  uint32_t key = ATClassifyDetail::lineKey(line, prefixLength);
+  if (!key || !mutex.take(pdMS_TO_TICKS(10))) { return nullptr; }
+  ATPromise* query = nullptr;
+  for (auto& promise : pendingPromises) {
+    if (promise && (promise->isQuery() || !queriesOnly) && !promise->isCompleted() &&
+        !promise->getLeaderId() && promise->answersWith(line, prefixLength, key)) {
+      query = promise.get();
+      break;
+    }
+  }
+  mutex.give();
+  return query;
+}
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <string>
+
+#include "bench_common.h"
+
+// Invocation cost of a URC handler capturing two references, std::function against ATDelegate.
+template <typename Callback>
+static void BM_InvokeCallback(benchmark::State& state) {
+  size_t calls = 0, bytes = 0;
+  Callback callback = [&calls, &bytes](const ATLineString& urc) {
+    calls++;
+    bytes += urc.length();
+  };
+  const ATLineString urc("+QIURC: \"recv\",0\r\n");
+
+  for (auto _ : state) {
+    callback(urc);
+    benchmark::DoNotOptimize(calls);
+  }
+  SetLineCounters(state, 1);
+}
+BENCHMARK_TEMPLATE(BM_InvokeCallback, std::function<void(const ATLineString&)>);
+BENCHMARK_TEMPLATE(BM_InvokeCallback, URCCallback);
+
+// A storm of +QIURC: "recv" notifications through framing, classification and dispatch.
+static void BM_URCStorm(benchmark::State& state) {
+  const size_t count = 64;
+  AsyncATHandler handler;
+  AsyncATHandlerProbe probe(handler);
+  ReplayStream stream;
+  std::string data;
+  for (size_t i = 0; i < count; i++) { data += "+QIURC: \"recv\",0\r\n"; }
+  stream.load(data);
+  probe.attach(stream);
+  size_t received = 0;
+  handler.onURC([&received](const ATLineString&) { received++; });
+
+  for (auto _ : state) {
+    stream.rewind();
+    probe.processIncomingData();
+  }
+
+  if (received != count * state.iterations()) { state.SkipWithError("URCs were lost"); }
+  state.SetBytesProcessed(static_cast<int64_t>(stream.size() * state.iterations()));
+  SetLineCounters(state, count);
+}
+BENCHMARK(BM_URCStorm);
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+// Grants AsyncATHandlerProbe access to the handler internals; the benchmark target sets it too.
+#ifndef AT_BENCHMARK_PROBE
+#define AT_BENCHMARK_PROBE 1
+#endif
+
+#include "AsyncATHandler.h"
+#include "Stream.h"
+#include "freertos/FreeRTOS.h"
+
+// Replays a fixed byte sequence without gmock dispatch or locking; writes are counted and dropped.
+class ReplayStream : public Stream {
+ private:
+  std::string data;
+  size_t position = 0;
+  size_t written = 0;
+
+ public:
+  void load(const std::string& bytes) {
+    data = bytes;
+    position = 0;
+  }
+  void rewind() { position = 0; }
+  size_t size() const { return data.size(); }
+  size_t bytesWritten() const { return written; }
+
+  int available() override { return static_cast<int>(data.size() - position); }
+  int read() override {
+    if (position >= data.size()) { return -1; }
+    return static_cast<uint8_t>(data[position++]);
+  }
+  int peek() override {
+    if (position >= data.size()) { return -1; }
+    return static_cast<uint8_t>(data[position]);
+  }
+  size_t write(uint8_t) override {
+    written++;
+    return 1;
+  }
+  size_t write(const uint8_t*, size_t size) override {
+    written += size;
+    return size;
+  }
+  void flush() override {}
+};
+
+// Gives benchmarks access to the handler's parsing pipeline without running the reader task.
+template <typename Config>
+class AsyncATHandlerProbe {
+ private:
+  BasicAsyncATHandler<Config>& handler;
+
+ public:
+  explicit AsyncATHandlerProbe(BasicAsyncATHandler<Config>& h) : handler(h) {}
+
+  void attach(Stream& stream) {
+    handler.stream = &stream;
+    handler.mutex.create();
+  }
+
+  // Claims a slot like sendCommand(), so popCompletedPromise() can release it again.
+  ATPromise* addPendingPromise() {
+    ATPromisePtr promise = handler.createPromise(handler.nextCommandId++);
+    ATPromise* raw = promise.get();
+    handler.pendingPromises.push_back(std::move(promise));
+    handler.inFlight.fetch_add(1, std::memory_order_relaxed);
+    return raw;
+  }
+
+  void clearPendingPromises() {
+    handler.inFlight.fetch_sub(handler.pendingPromises.size(), std::memory_order_relaxed);
+    handler.pendingPromises.clear();
+  }
+  size_t inFlight() const { return handler.inFlight.load(std::memory_order_relaxed); }
+  size_t pendingCount() const { return handler.pendingPromises.size(); }
+
+  void processIncomingData() { handler.processIncomingData(); }
+  ResponseType classifyLine(const String& line) {
+    return handler.classifyLine(line.c_str(), line.length());
+  }
+  ATPromise* findPromiseForResponse(const String& line) {
+    return handler.findPromiseForResponse(line.c_str(), line.length());
+  }
+};
+
+inline void SetLineCounters(benchmark::State& state, size_t linesPerIteration) {
+  state.counters["lines/s"] = benchmark::Counter(
+      static_cast<double>(linesPerIteration * state.iterations()), benchmark::Counter::kIsRate);
+}
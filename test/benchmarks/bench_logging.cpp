@@ -0,0 +1,30 @@
+#include <benchmark/benchmark.h>
+
+#include "ATLog/ATLog.h"
+#include "bench_common.h"
+
+// Hot-path cost of an info-level message in AT_LOG_DEFERRED mode, e.g. sendCommand()'s
+// "Sending command [%u]: %s".
+static void BM_DeferredLogRecord(benchmark::State& state) {
+  static ATDeferredLog log;
+  uint32_t id = 0;
+  for (auto _ : state) { log.record(3, "Sending command [%u]: %s", ++id, "AT+QISTATE=1,0"); }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeferredLogRecord);
+
+// Formatting cost moved off the hot path, paid by whoever drains the log.
+static void BM_DeferredLogDrain(benchmark::State& state) {
+  static ATDeferredLog log;
+  size_t drained = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (int i = 0; i < AT_LOG_DEFERRED_CAPACITY; i++) {
+      log.record(3, "Sending command [%u]: %s", static_cast<unsigned>(i), "AT+QISTATE=1,0");
+    }
+    state.ResumeTiming();
+    drained += log.drain([](const ATLogRecord&, const char*, void*) {}, nullptr);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(drained));
+}
+BENCHMARK(BM_DeferredLogDrain);
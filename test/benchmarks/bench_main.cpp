@@ -0,0 +1,22 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+
+// Promises and the handler mutex need a running scheduler, as in the native tests.
+int main(int argc, char** argv) {
+  std::thread schedulerThread([]() { vTaskStartScheduler(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  benchmark::Initialize(&argc, argv);
+  bool badArguments = benchmark::ReportUnrecognizedArguments(argc, argv);
+  if (!badArguments) { benchmark::RunSpecifiedBenchmarks(); }
+  benchmark::Shutdown();
+
+  vTaskEndScheduler();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  schedulerThread.join();
+  return badArguments ? 1 : 0;
+}
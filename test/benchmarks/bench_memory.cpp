@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_common.h"
+
+// One command's allocations end to end: promise and expectation, the routed lines and their text,
+// then release on pop. With the arena, frees are no-ops and the buffer is rewound between batches.
+static void BM_CommandLifecycle(benchmark::State& state, bool useArena) {
+  static unsigned char buffer[64 * 1024];
+  ATMonotonicArena arena(buffer, sizeof(buffer));
+  AsyncATHandler handler(useArena ? &arena : nullptr);
+  AsyncATHandlerProbe probe(handler);
+  ReplayStream stream;
+  stream.load("AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  probe.attach(stream);
+
+  for (auto _ : state) {
+    ATPromise* promise = probe.addPendingPromise()->expect("OK");
+    stream.rewind();
+    probe.processIncomingData();
+    bool completed = promise->isCompleted();
+    handler.popCompletedPromise(promise->getId());
+    if (!completed) {
+      state.SkipWithError("Promise was not completed");
+      break;
+    }
+    if (useArena && arena.getUsedBytes() > sizeof(buffer) / 2) {
+      state.PauseTiming();
+      arena.reset();
+      state.ResumeTiming();
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(stream.size() * state.iterations()));
+  SetLineCounters(state, 3);
+  if (probe.inFlight() != probe.pendingCount()) { state.SkipWithError("Slots out of step"); }
+  state.counters["overflows"] = static_cast<double>(arena.getOverflowCount());
+}
+BENCHMARK_CAPTURE(BM_CommandLifecycle, default_allocator, false);
+BENCHMARK_CAPTURE(BM_CommandLifecycle, monotonic_arena, true);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+
+// A representative slice of a Quectel session: echoes, data, URCs and final result codes.
+static const char* const kSessionLines[] = {
+    "AT+CSQ\r\n",
+    "+CSQ: 20,99\r\n",
+    "OK\r\n",
+    "AT+CEREG?\r\n",
+    "+CEREG: 2,1,\"1A2B\",\"01A2D101\",7\r\n",
+    "OK\r\n",
+    "+QIURC: \"recv\",0\r\n",
+    "AT+QISTATE=1,0\r\n",
+    "+QISTATE: 0,\"TCP\",\"220.180.239.212\",8062,0,2,0,1\r\n",
+    "OK\r\n",
+    "+CME ERROR: 58\r\n",
+    "ERROR\r\n",
+};
+static const size_t kSessionLineCount = sizeof(kSessionLines) / sizeof(kSessionLines[0]);
+
+static std::string BuildSession(size_t repeats) {
+  std::string data;
+  for (size_t i = 0; i < repeats; i++) {
+    for (const char* line : kSessionLines) { data += line; }
+  }
+  return data;
+}
+
+// Byte-by-byte framing, classification and dispatch with no promise waiting.
+static void BM_LineFraming(benchmark::State& state) {
+  const size_t repeats = 16;
+  AsyncATHandler handler;
+  AsyncATHandlerProbe probe(handler);
+  ReplayStream stream;
+  stream.load(BuildSession(repeats));
+  probe.attach(stream);
+
+  for (auto _ : state) {
+    stream.rewind();
+    probe.processIncomingData();
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(stream.size() * state.iterations()));
+  SetLineCounters(state, kSessionLineCount * repeats);
+}
+BENCHMARK(BM_LineFraming);
+
+static void BM_ClassifyLine(benchmark::State& state) {
+  AsyncATHandler handler;
+  AsyncATHandlerProbe probe(handler);
+  std::vector<String> lines(kSessionLines, kSessionLines + kSessionLineCount);
+  size_t bytes = 0;
+  for (const auto& line : lines) { bytes += line.length(); }
+
+  for (auto _ : state) {
+    for (const auto& line : lines) { benchmark::DoNotOptimize(probe.classifyLine(line)); }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+  SetLineCounters(state, lines.size());
+}
+BENCHMARK(BM_ClassifyLine);
+
+// Compiled expectations against the session lines: a literal, an anchored pattern with a range
+// and a wildcard pattern with captures.
+static void BM_MatchExpectation(benchmark::State& state) {
+  static const ATMatcher kMatchers[] = {
+      ATMatcher::literal("+QIOPEN:"),
+      ATMatcher("^+CEREG: %d,%d[1:5]*"),
+      ATMatcher("+QISTATE: %d,%s,*,%d$"),
+  };
+  const ATMatcher& matcher = kMatchers[state.range(0)];
+  ATCaptures captures;
+  size_t bytes = 0;
+  for (const char* line : kSessionLines) { bytes += strlen(line); }
+
+  for (auto _ : state) {
+    for (const char* line : kSessionLines) {
+      benchmark::DoNotOptimize(matcher.match(line, strlen(line), &captures));
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+  SetLineCounters(state, kSessionLineCount);
+}
+BENCHMARK(BM_MatchExpectation)->Arg(0)->Arg(1)->Arg(2);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+
+#include "bench_common.h"
+
+static ATResponse BuildResponse() {
+  static const char* const lines[] = {
+      "AT+QISTATE\r\n",
+      "+QISTATE: 0,\"TCP\",\"220.180.239.212\",8062,0,2,0,1\r\n",
+      "+QISTATE: 1,\"UDP\",\"10.0.0.1\",5000,0,2,0,1\r\n",
+      "+QISTATE: 2,\"TCP\",\"10.0.0.2\",443,0,4,0,1\r\n",
+      "OK\r\n",
+  };
+  ATResponse response(1);
+  for (const char* content : lines) {
+    ResponseLine line;
+    line.content = content;
+    line.type =
+        strcmp(content, "OK\r\n") == 0 ? ResponseType::FINAL_OK : ResponseType::INTERMEDIATE_DATA;
+    line.commandId = 1;
+    line.timestamp = 0;
+    response.addLine(line);
+  }
+  return response;
+}
+
+static void BM_GetFullResponse(benchmark::State& state) {
+  ATResponse response = BuildResponse();
+  for (auto _ : state) { benchmark::DoNotOptimize(response.getFullResponse()); }
+  SetLineCounters(state, 5);
+}
+BENCHMARK(BM_GetFullResponse);
+
+static void BM_GetDataLines(benchmark::State& state) {
+  ATResponse response = BuildResponse();
+  for (auto _ : state) { benchmark::DoNotOptimize(response.getDataLines()); }
+  SetLineCounters(state, 5);
+}
+BENCHMARK(BM_GetDataLines);
+
+static void BM_ContainsResponse(benchmark::State& state) {
+  ATResponse response = BuildResponse();
+  const String needle = "10.0.0.2";
+  for (auto _ : state) { benchmark::DoNotOptimize(response.containsResponse(needle)); }
+  SetLineCounters(state, 5);
+}
+BENCHMARK(BM_ContainsResponse);
+
+static void BM_ScanFields(benchmark::State& state) {
+  ATResponse response = BuildResponse();
+  for (auto _ : state) {
+    int id = 0, port = 0, socketState = 0;
+    char service[8];
+    benchmark::DoNotOptimize(response.scan(
+        "+QISTATE:", id, ATFields::text(service), ATFields::Skip(), port, ATFields::Skip(),
+        socketState));
+  }
+  SetLineCounters(state, 1);
+}
+BENCHMARK(BM_ScanFields);
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "bench_common.h"
+
+// Worst case lookup: every pending promise carries an expectation that does not match, so the
+// router scans all of them before falling back to the oldest.
+static void BM_FindPromiseForResponse(benchmark::State& state) {
+  AsyncATHandler handler;
+  AsyncATHandlerProbe probe(handler);
+  for (int64_t i = 0; i < state.range(0); i++) { probe.addPendingPromise()->expect("+QIOPEN:"); }
+  const String line = "+CSQ: 20,99\r\n";
+
+  for (auto _ : state) { benchmark::DoNotOptimize(probe.findPromiseForResponse(line)); }
+
+  state.SetBytesProcessed(static_cast<int64_t>(line.length() * state.iterations()));
+  SetLineCounters(state, 1);
+  probe.clearPendingPromises();
+}
+BENCHMARK(BM_FindPromiseForResponse)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+// Same pipeline with the promise-list mutex compiled out, to isolate the locking cost.
+struct UnlockedConfig : DefaultATHandlerConfig {
+  using Lock = ATNullLock;
+};
+
+// Full receive path for one command: frame, classify, route and complete a pending promise while
+// other completed promises are still waiting to be claimed by their callers.
+template <typename Config>
+static void BM_RouteToPendingPromise(benchmark::State& state) {
+  BasicAsyncATHandler<Config> handler;
+  AsyncATHandlerProbe probe(handler);
+  ReplayStream stream;
+  stream.load("AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  probe.attach(stream);
+
+  ResponseLine ok;
+  ok.content = "OK\r\n";
+  ok.type = ResponseType::FINAL_OK;
+  for (int64_t i = 1; i < state.range(0); i++) { probe.addPendingPromise()->addResponseLine(ok); }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    ATPromise* promise = probe.addPendingPromise();
+    stream.rewind();
+    state.ResumeTiming();
+
+    probe.processIncomingData();
+
+    state.PauseTiming();
+    bool completed = promise->isCompleted();
+    handler.popCompletedPromise(promise->getId());
+    if (!completed) {
+      state.SkipWithError("Promise was not completed");
+      break;
+    }
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(stream.size() * state.iterations()));
+  SetLineCounters(state, 3);
+  if (probe.inFlight() != probe.pendingCount()) { state.SkipWithError("Slots out of step"); }
+  probe.clearPendingPromises();
+}
+BENCHMARK_TEMPLATE(BM_RouteToPendingPromise, DefaultATHandlerConfig)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK_TEMPLATE(BM_RouteToPendingPromise, UnlockedConfig)->Arg(1)->Arg(4)->Arg(16);
@@ -0,0 +1,13 @@
+#include <benchmark/benchmark.h>
+
+#include "ATTrace/ATTrace.h"
+#include "bench_common.h"
+
+// Cost of one trace event, the price of leaving AT_TRACE_ENABLED on.
+static void BM_TraceRecord(benchmark::State& state) {
+  static ATTrace trace;
+  uint32_t id = 0;
+  for (auto _ : state) { trace.record(ATTraceEventType::LINE_ROUTED, ++id, 12); }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TraceRecord)->Threads(1)->Threads(2);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <thread>
+
+#include "ATRingBuffer/ATRingBuffer.h"
+#include "Stream.h"
+
+// High-throughput in-memory serial link for stress and benchmark tests. LoopbackStream is the
+// host side handed to the handler; modem() is the paired endpoint a simulator reads commands from
+// and writes responses to. Each direction is a lock-free SPSC ring, so one thread per side may use
+// it without locks or gmock dispatch. Writes block (yielding) while the peer's ring is full, like a
+// UART driver with a full TX FIFO.
+class LoopbackEndpoint : public Stream {
+ public:
+  static constexpr size_t kCapacity = 16 * 1024;
+  using Ring = ATRingBuffer<kCapacity>;
+
+ private:
+  Ring& rx;
+  Ring& tx;
+
+ public:
+  LoopbackEndpoint(Ring& rxRing, Ring& txRing) : rx(rxRing), tx(txRing) {}
+
+  int available() override { return static_cast<int>(rx.available()); }
+  int read() override { return rx.pop(); }
+  int peek() override { return rx.peek(); }
+  size_t readBytes(uint8_t* buffer, size_t size) { return rx.read(buffer, size); }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    size_t written = 0;
+    while (written < size) {
+      size_t chunk = tx.write(buffer + written, size - written);
+      if (chunk == 0) { std::this_thread::yield(); }
+      written += chunk;
+    }
+    return written;
+  }
+  // Bytes are on the "wire" once they are in the peer's ring.
+  void flush() override {}
+
+  // Drops unread input, e.g. between test phases.
+  void clearInput() { rx.clear(); }
+};
+
+struct LoopbackRings {
+  LoopbackEndpoint::Ring toHost;
+  LoopbackEndpoint::Ring toModem;
+};
+
+class LoopbackStream : private LoopbackRings, public LoopbackEndpoint {
+ private:
+  LoopbackEndpoint modemEndpoint;
+
+ public:
+  LoopbackStream() : LoopbackEndpoint(toHost, toModem), modemEndpoint(toModem, toHost) {}
+
+  LoopbackEndpoint& modem() { return modemEndpoint; }
+};
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LoopbackStream.h"
+
+// Local stand-in for a Quectel-style modem. It reads command lines from the modem side of a
+// LoopbackStream, answers from a rule table and models latency, UART baud rate and jitter:
+//
+//   ModemSimulator modem;
+//   modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+//   modem.on("AT+QIOPEN=*").ok().urc("+QIOPEN: 0,0", 150000);
+//   modem.on("AT+QISEND=*").payload().final("SEND OK");
+//   modem.begin();
+//   handler.begin(modem.stream());
+//
+// Patterns match the whole command line; a trailing '*' makes them a prefix match. Commands
+// without a rule get the default final result ("ERROR").
+class ModemSimulator {
+ public:
+  struct Timing {
+    uint32_t baudRate = 0;        // 0 transmits instantly, otherwise 10 bits per byte
+    uint32_t defaultLatencyUs = 0;
+    uint32_t jitterUs = 0;        // Uniformly distributed extra latency per command
+  };
+
+  class Rule {
+    friend class ModemSimulator;
+
+   private:
+    std::string pattern;
+    std::vector<std::string> lines;
+    std::string finalResult = "OK";
+    std::vector<std::pair<uint32_t, std::string>> urcs;
+    int64_t latencyUs = -1;
+    bool acceptsPayload = false;
+    int remaining = -1;  // Uses left, -1 for unlimited
+
+    bool matches(const std::string& command) const {
+      if (!pattern.empty() && pattern.back() == '*') {
+        return command.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+      }
+      return command == pattern;
+    }
+
+   public:
+    explicit Rule(const std::string& p) : pattern(p) {}
+
+    Rule& reply(const std::string& line) {
+      lines.push_back(line);
+      return *this;
+    }
+    Rule& ok() { return final("OK"); }
+    Rule& error(const std::string& result = "ERROR") { return final(result); }
+    Rule& final(const std::string& result) {
+      finalResult = result;
+      return *this;
+    }
+    // Emits an unsolicited line this many microseconds after the final result.
+    Rule& urc(const std::string& line, uint32_t delayUs) {
+      urcs.emplace_back(delayUs, line);
+      return *this;
+    }
+    Rule& latency(uint32_t us) {
+      latencyUs = us;
+      return *this;
+    }
+    // Sends a '>' prompt and reads as many raw bytes as the command's last numeric argument
+    // before answering, like AT+QISEND=<id>,<length>.
+    Rule& payload() {
+      acceptsPayload = true;
+      return *this;
+    }
+    // Answers only the first matching command; later ones fall through to the next rule.
+    Rule& once() {
+      remaining = 1;
+      return *this;
+    }
+  };
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct PendingURC {
+    Clock::time_point due;
+    std::string line;
+  };
+
+  LoopbackStream link;
+  Timing timing;
+  std::deque<Rule> rules;
+  std::string defaultResult = "ERROR";
+  bool echo = true;
+
+  std::thread worker;
+  std::atomic<bool> running{false};
+  std::mutex stateMutex;
+  std::vector<PendingURC> pendingURCs;
+  std::vector<std::string> commandLog;
+  std::vector<std::string> payloadLog;
+  std::mt19937 random{12345};
+
+  LoopbackEndpoint& port() { return link.modem(); }
+
+  void pause(int64_t us) {
+    if (us > 0) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+  }
+
+  void transmit(const std::string& text) {
+    if (timing.baudRate) {
+      pause(static_cast<int64_t>(text.size()) * 10000000LL / timing.baudRate);
+    }
+    port().write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+  }
+
+  const Rule* findRule(const std::string& command) {
+    for (auto& rule : rules) {
+      if (rule.remaining != 0 && rule.matches(command)) {
+        if (rule.remaining > 0) { rule.remaining--; }
+        return &rule;
+      }
+    }
+    return nullptr;
+  }
+
+  size_t payloadLength(const std::string& command) const {
+    size_t pos = command.find_last_of(",=");
+    return pos == std::string::npos ? 0 : strtoul(command.c_str() + pos + 1, nullptr, 10);
+  }
+
+  void readPayload(size_t length) {
+    std::string payload(length, '\0');
+    size_t received = 0;
+    auto deadline = Clock::now() + std::chrono::seconds(5);
+    while (received < length && running.load() && Clock::now() < deadline) {
+      size_t count =
+          port().readBytes(reinterpret_cast<uint8_t*>(&payload[received]), length - received);
+      if (count == 0) { std::this_thread::sleep_for(std::chrono::microseconds(100)); }
+      received += count;
+    }
+    payload.resize(received);
+    std::lock_guard<std::mutex> lock(stateMutex);
+    payloadLog.push_back(payload);
+  }
+
+  void handleCommand(const std::string& command) {
+    {
+      std::lock_guard<std::mutex> lock(stateMutex);
+      commandLog.push_back(command);
+    }
+    if (echo) { transmit(command + "\r\n"); }
+
+    const Rule* rule = findRule(command);
+    int64_t latencyUs = rule && rule->latencyUs >= 0 ? rule->latencyUs : timing.defaultLatencyUs;
+    if (timing.jitterUs) {
+      latencyUs += std::uniform_int_distribution<uint32_t>(0, timing.jitterUs)(random);
+    }
+    pause(latencyUs);
+
+    if (!rule) {
+      transmit(defaultResult + "\r\n");
+      return;
+    }
+
+    if (rule->acceptsPayload) {
+      if (port().peek() == '\n') { port().read(); }  // Rest of the command's "\r\n"
+      transmit(">\r\n");
+      readPayload(payloadLength(command));
+    }
+    for (const auto& line : rule->lines) { transmit(line + "\r\n"); }
+    transmit(rule->finalResult + "\r\n");
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    for (const auto& urc : rule->urcs) {
+      pendingURCs.push_back({Clock::now() + std::chrono::microseconds(urc.first), urc.second});
+    }
+  }
+
+  void emitDueURCs() {
+    std::vector<std::string> due;
+    {
+      std::lock_guard<std::mutex> lock(stateMutex);
+      auto now = Clock::now();
+      for (auto it = pendingURCs.begin(); it != pendingURCs.end();) {
+        if (it->due <= now) {
+          due.push_back(it->line);
+          it = pendingURCs.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (const auto& line : due) { transmit(line + "\r\n"); }
+  }
+
+  void run() {
+    std::string line;
+    while (running.load()) {
+      emitDueURCs();
+      int c = port().read();
+      if (c < 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        continue;
+      }
+      if (c == '\n') { continue; }
+      if (c != '\r') {
+        line += static_cast<char>(c);
+        continue;
+      }
+      if (!line.empty()) { handleCommand(line); }
+      line.clear();
+    }
+  }
+
+ public:
+  ModemSimulator() = default;
+  explicit ModemSimulator(const Timing& t) : timing(t) {}
+  ~ModemSimulator() { end(); }
+
+  // Rules must be added before begin().
+  Rule& on(const std::string& pattern) {
+    rules.emplace_back(pattern);
+    return rules.back();
+  }
+  void setDefaultResult(const std::string& result) { defaultResult = result; }
+  void setEcho(bool enabled) { echo = enabled; }
+  void setTiming(const Timing& t) { timing = t; }
+
+  void begin() {
+    if (running.exchange(true)) { return; }
+    worker = std::thread([this]() { run(); });
+  }
+
+  void end() {
+    running = false;
+    if (worker.joinable()) { worker.join(); }
+  }
+
+  // Host side of the link, to be passed to AsyncATHandler::begin().
+  LoopbackStream& stream() { return link; }
+
+  // Queues an unsolicited line, e.g. a network registration change.
+  void sendURC(const std::string& line, uint32_t delayUs = 0) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    pendingURCs.push_back({Clock::now() + std::chrono::microseconds(delayUs), line});
+  }
+
+  std::vector<std::string> receivedCommands() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return commandLog;
+  }
+
+  // Data read after each '>' prompt, in order.
+  std::vector<std::string> receivedPayloads() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return payloadLog;
+  }
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LoopbackStream.h"
+#include "ModemSimulator.h"
+
+// Modem side of a 3GPP TS 27.010 multiplexer (basic option), for testing ATMux locally. Each
+// DLCI is served by its own ModemSimulator, so channels answer independently and a slow command
+// on one does not hold up the others:
+//
+//   MuxModemSimulator modem(2);
+//   modem.channel(1).on("AT+CSQ").reply("+CSQ: 20,99").ok();
+//   modem.channel(2).on("AT+QFREAD=*").latency(300000).reply("CONNECT 4").ok();
+//   modem.begin();
+//   mux.begin(modem.stream(), 2);
+//
+// The framing is written independently of ATMuxFrame so the two check each other.
+class MuxModemSimulator {
+ private:
+  static constexpr uint8_t kUIH = 0xEF;
+
+  LoopbackStream link;
+  std::vector<std::unique_ptr<ModemSimulator>> channels;
+  std::vector<bool> opened;
+  size_t frameSize;
+
+  std::thread worker;
+  std::atomic<bool> running{false};
+  std::mutex stateMutex;
+  std::vector<uint8_t> input;
+  std::vector<std::string> controlResponses;
+  std::vector<int> refused;
+  bool closedDown = false;
+  size_t badFrames = 0;
+
+  static uint8_t checksum(const uint8_t* data, size_t length) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < length; i++) {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; bit++) { crc = (crc & 1) ? (crc >> 1) ^ 0xE0 : crc >> 1; }
+    }
+    return 0xFF - crc;
+  }
+
+  void sendFrame(int dlci, uint8_t control, bool command, const std::string& data) {
+    std::vector<uint8_t> frame = {0xF9, static_cast<uint8_t>((dlci << 2) | (command ? 0 : 2) | 1)};
+    frame.push_back(control);
+    if (data.size() < 128) {
+      frame.push_back(static_cast<uint8_t>((data.size() << 1) | 1));
+    } else {
+      frame.push_back(static_cast<uint8_t>(data.size() << 1));
+      frame.push_back(static_cast<uint8_t>(data.size() >> 7));
+    }
+    uint8_t check = checksum(frame.data() + 1, frame.size() - 1);
+    frame.insert(frame.end(), data.begin(), data.end());
+    frame.push_back(check);
+    frame.push_back(0xF9);
+    link.modem().write(frame.data(), frame.size());
+  }
+
+  void handleFrame(int dlci, uint8_t control, const std::string& data) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    switch (control & ~0x10) {
+      case 0x2F: {  // SABM
+        bool refuse = dlci > static_cast<int>(channels.size());
+        for (int r : refused) { refuse = refuse || r == dlci; }
+        if (!refuse && dlci > 0) { opened[dlci - 1] = true; }
+        sendFrame(dlci, refuse ? 0x1F : 0x73, false, "");
+        break;
+      }
+      case 0x43:  // DISC
+        if (dlci > 0 && dlci <= static_cast<int>(channels.size())) { opened[dlci - 1] = false; }
+        sendFrame(dlci, 0x73, false, "");
+        break;
+      case kUIH:
+        if (dlci == 0) {
+          if (!data.empty() && data[0] == '\xC3') {  // CLD command
+            closedDown = true;
+            for (size_t i = 0; i < opened.size(); i++) { opened[i] = false; }
+            sendFrame(0, kUIH, false, std::string("\xC1\x01", 2));
+          } else if (!data.empty() && !(data[0] & 2)) {
+            controlResponses.push_back(data);
+          }
+        } else if (dlci <= static_cast<int>(channels.size()) && opened[dlci - 1]) {
+          channels[dlci - 1]->stream().write(
+              reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Consumes complete frames from the front of input.
+  void parseInput() {
+    while (true) {
+      size_t start = 0;
+      while (start < input.size() && input[start] == 0xF9) { start++; }
+      input.erase(input.begin(), input.begin() + start);
+      if (input.size() < 4) { return; }
+      size_t headerLength = (input[2] & 1) ? 3 : 4;
+      size_t length = input[2] >> 1;
+      if (headerLength == 4) { length |= static_cast<size_t>(input[3]) << 7; }
+      size_t total = headerLength + length + 2;
+      if (input.size() < total) { return; }
+      bool valid = input[headerLength + length] == checksum(input.data(), headerLength) &&
+                   input[total - 1] == 0xF9;
+      if (valid) {
+        std::string data(input.begin() + headerLength, input.begin() + headerLength + length);
+        handleFrame(input[0] >> 2, input[1], data);
+        input.erase(input.begin(), input.begin() + total - 1);  // Keep the closing flag
+      } else {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        badFrames++;
+        input.erase(input.begin());
+      }
+    }
+  }
+
+  void forwardReplies() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    uint8_t buffer[256];
+    for (size_t i = 0; i < channels.size(); i++) {
+      LoopbackStream& port = channels[i]->stream();
+      while (opened[i] && port.available() > 0) {
+        size_t count = port.readBytes(buffer, std::min<size_t>(frameSize, sizeof(buffer)));
+        sendFrame(static_cast<int>(i + 1), kUIH, true, std::string(buffer, buffer + count));
+      }
+    }
+  }
+
+  void run() {
+    uint8_t buffer[256];
+    while (running.load()) {
+      size_t count = link.modem().readBytes(buffer, sizeof(buffer));
+      if (count) {
+        input.insert(input.end(), buffer, buffer + count);
+        parseInput();
+      }
+      forwardReplies();
+      if (!count) { std::this_thread::sleep_for(std::chrono::microseconds(200)); }
+    }
+  }
+
+ public:
+  explicit MuxModemSimulator(size_t channelCount, size_t n1 = 127)
+      : opened(channelCount, false), frameSize(n1) {
+    for (size_t i = 0; i < channelCount; i++) {
+      channels.push_back(std::make_unique<ModemSimulator>());
+    }
+  }
+  ~MuxModemSimulator() { end(); }
+
+  // Simulator behind DLCI dlci (1-based). Rules must be added before begin().
+  ModemSimulator& channel(int dlci) { return *channels[dlci - 1]; }
+  // Answers SABM for dlci with DM.
+  void refuse(int dlci) { refused.push_back(dlci); }
+
+  void begin() {
+    if (running.exchange(true)) { return; }
+    for (auto& channel : channels) { channel->begin(); }
+    worker = std::thread([this]() { run(); });
+  }
+
+  void end() {
+    running = false;
+    if (worker.joinable()) { worker.join(); }
+    for (auto& channel : channels) { channel->end(); }
+  }
+
+  // Host side of the physical link, to be passed to ATMux::begin().
+  LoopbackStream& stream() { return link; }
+
+  // Sends a modem status command for dlci on the control channel.
+  void sendModemStatus(int dlci) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::string msc = {'\xE3', '\x05', static_cast<char>((dlci << 2) | 3), '\x8D'};
+    sendFrame(0, kUIH, true, msc);
+  }
+
+  // Writes raw bytes to the host, e.g. a corrupted frame.
+  void sendRaw(const std::string& bytes) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    link.modem().write(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+  }
+
+  bool isOpen(int dlci) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return opened[dlci - 1];
+  }
+  bool isClosedDown() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return closedDown;
+  }
+  std::vector<std::string> receivedControlResponses() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return controlResponses;
+  }
+  size_t getBadFrames() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return badFrames;
+  }
+};
@@ -55,27 +55,18 @@ static inline void _log_write(
   std::cout << LOG_COLOR_RESET << std::endl;
 }
 
-#define log_e(fmt, ...) \
-  _log_write(           \
-      LOG_LEVEL_ERROR, LOG_COLOR_RED, "[ERROR] ", __SHORT_FILE__, __LINE__, fmt, ##__VA_ARGS__)
-
-#define log_w(fmt, ...) \
-  _log_write(           \
-      LOG_LEVEL_WARN, LOG_COLOR_YELLOW, "[WARN] ", __SHORT_FILE__, __LINE__, fmt, ##__VA_ARGS__)
-
-#define log_i(fmt, ...) \
-  _log_write(           \
-      LOG_LEVEL_INFO, LOG_COLOR_GREEN, "[INFO] ", __SHORT_FILE__, __LINE__, fmt, ##__VA_ARGS__)
-
-#define log_d(fmt, ...) \
-  _log_write(           \
-      LOG_LEVEL_DEBUG, LOG_COLOR_CYAN, "[DEBUG] ", __SHORT_FILE__, __LINE__, fmt, ##__VA_ARGS__)
-
-#define log_v(fmt, ...)                                                               \
-  _log_write(                                                                         \
-      LOG_LEVEL_VERBOSE, LOG_COLOR_GRAY, "[VERBOSE] ", __SHORT_FILE__, __LINE__, fmt, \
-      ##__VA_ARGS__)
-
-#define log_n(fmt, ...) \
-  _log_write(           \
-      LOG_LEVEL_NONE, LOG_COLOR_RESET, "[NONE] ", __SHORT_FILE__, __LINE__, fmt, ##__VA_ARGS__)
+// Like the ESP32 core, calls above LOG_LEVEL are removed at compile time and their arguments
+// are not evaluated.
+#define _log_at(level, color, prefix, fmt, ...)                                        \
+  do {                                                                                 \
+    if ((level) <= LOG_LEVEL) {                                                        \
+      _log_write(level, color, prefix, __SHORT_FILE__, __LINE__, fmt, ##__VA_ARGS__); \
+    }                                                                                  \
+  } while (0)
+
+#define log_e(fmt, ...) _log_at(LOG_LEVEL_ERROR, LOG_COLOR_RED, "[ERROR] ", fmt, ##__VA_ARGS__)
+#define log_w(fmt, ...) _log_at(LOG_LEVEL_WARN, LOG_COLOR_YELLOW, "[WARN] ", fmt, ##__VA_ARGS__)
+#define log_i(fmt, ...) _log_at(LOG_LEVEL_INFO, LOG_COLOR_GREEN, "[INFO] ", fmt, ##__VA_ARGS__)
+#define log_d(fmt, ...) _log_at(LOG_LEVEL_DEBUG, LOG_COLOR_CYAN, "[DEBUG] ", fmt, ##__VA_ARGS__)
+#define log_v(fmt, ...) _log_at(LOG_LEVEL_VERBOSE, LOG_COLOR_GRAY, "[VERBOSE] ", fmt, ##__VA_ARGS__)
+#define log_n(fmt, ...) _log_at(LOG_LEVEL_NONE, LOG_COLOR_RESET, "[NONE] ", fmt, ##__VA_ARGS__)
@@ -14,3 +14,14 @@ inline BaseType_t xTaskCreatePinnedToCore(
     BaseType_t coreID) {
   return xTaskCreate(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask);
 }
+
+#if configSUPPORT_STATIC_ALLOCATION
+inline TaskHandle_t xTaskCreateStaticPinnedToCore(
+    TaskFunction_t pxTaskCode, const char* const pcName, const uint32_t ulStackDepth,
+    void* const pvParameters, UBaseType_t uxPriority, StackType_t* const puxStackBuffer,
+    StaticTask_t* const pxTaskBuffer, const BaseType_t xCoreID) {
+  (void)xCoreID;
+  return xTaskCreateStatic(
+      pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, puxStackBuffer, pxTaskBuffer);
+}
+#endif
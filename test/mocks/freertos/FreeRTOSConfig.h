@@ -32,6 +32,8 @@
 #define configUSE_APPLICATION_TASK_TAG 1
 #define configUSE_COUNTING_SEMAPHORES 1
 #define configUSE_ALTERNATIVE_API 0
+#define configSUPPORT_STATIC_ALLOCATION 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
 // #define configMAX_SYSCALL_INTERRUPT_PRIORITY	1
 
 #define configUSE_QUEUE_SETS 1
@@ -8,6 +8,27 @@ void vApplicationIdleHook(void) {}
 
 void vApplicationTickHook(void) {}
 
+/* Required by configSUPPORT_STATIC_ALLOCATION for the idle and timer service tasks. */
+void vApplicationGetIdleTaskMemory(
+    StaticTask_t** ppxIdleTaskTCBBuffer, StackType_t** ppxIdleTaskStackBuffer,
+    uint32_t* pulIdleTaskStackSize) {
+  static StaticTask_t idleTaskTCB;
+  static StackType_t idleTaskStack[configMINIMAL_STACK_SIZE];
+  *ppxIdleTaskTCBBuffer = &idleTaskTCB;
+  *ppxIdleTaskStackBuffer = idleTaskStack;
+  *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(
+    StaticTask_t** ppxTimerTaskTCBBuffer, StackType_t** ppxTimerTaskStackBuffer,
+    uint32_t* pulTimerTaskStackSize) {
+  static StaticTask_t timerTaskTCB;
+  static StackType_t timerTaskStack[configTIMER_TASK_STACK_DEPTH];
+  *ppxTimerTaskTCBBuffer = &timerTaskTCB;
+  *ppxTimerTaskStackBuffer = timerTaskStack;
+  *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
 void vApplicationMallocFailedHook(void) {
   fprintf(stderr, "FreeRTOS: Malloc failed - Free heap: %zu bytes\n", xPortGetFreeHeapSize());
   abort();
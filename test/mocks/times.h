@@ -9,4 +9,10 @@ inline unsigned long millis() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
 }
 
+inline unsigned long micros() {
+  static auto start = std::chrono::steady_clock::now();
+  auto now = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+}
+
 inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
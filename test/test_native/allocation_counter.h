@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations by replacing the global allocation functions, array, sized, aligned
+// and nothrow forms included, so every new is paired with its matching delete. Replacement
+// functions cannot be inline: include this header from exactly one file per test binary.
+//
+// g_allocations counts while g_countAllocations is set; tests compare it before and after the
+// code under test.
+
+inline std::atomic<bool> g_countAllocations{true};
+inline std::atomic<size_t> g_allocations{0};
+
+namespace AllocationCounter {
+
+inline void* allocate(size_t size, size_t alignment = 0) {
+  if (g_countAllocations) { g_allocations++; }
+  if (size == 0) { size = 1; }
+  if (alignment <= alignof(std::max_align_t)) { return std::malloc(size); }
+  return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+inline void* allocateOrThrow(size_t size, size_t alignment = 0) {
+  void* p = allocate(size, alignment);
+  if (!p) { throw std::bad_alloc(); }
+  return p;
+}
+
+// Out of line so GCC does not see free() applied to the result of operator new once a delete
+// is inlined into its caller, which it reports as -Wmismatched-new-delete.
+[[gnu::noinline]] inline void release(void* p) noexcept { std::free(p); }
+
+}  // namespace AllocationCounter
+
+void* operator new(size_t size) { return AllocationCounter::allocateOrThrow(size); }
+void* operator new[](size_t size) { return AllocationCounter::allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return AllocationCounter::allocate(size);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return AllocationCounter::allocate(size);
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+  return AllocationCounter::allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return AllocationCounter::allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AllocationCounter::allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AllocationCounter::allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { AllocationCounter::release(p); }
+void operator delete[](void* p) noexcept { AllocationCounter::release(p); }
+void operator delete(void* p, size_t) noexcept { AllocationCounter::release(p); }
+void operator delete[](void* p, size_t) noexcept { AllocationCounter::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { AllocationCounter::release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { AllocationCounter::release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { AllocationCounter::release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AllocationCounter::release(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+  AllocationCounter::release(p);
+}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+  AllocationCounter::release(p);
+}
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+  AllocationCounter::release(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+  AllocationCounter::release(p);
+}
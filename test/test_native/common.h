@@ -128,7 +128,8 @@ inline void InjectDataWithDelay(
 }
 
 // Common teardown pattern for AT handler tests
-inline bool CleanupATHandler(class AsyncATHandler* handler) {
+template <typename Handler>
+inline bool CleanupATHandler(Handler* handler) {
   return runInFreeRTOSTask([handler]() { handler->end(); }, "TeardownTask");
 }
 
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+struct CachingConfig : DefaultATHandlerConfig {
+  static constexpr size_t MaxCachedCommands = 2;
+};
+
+struct CoalescingConfig : DefaultATHandlerConfig {
+  static constexpr bool CoalesceQueries = true;
+};
+
+class ATResponseCacheTest : public FreeRTOSTest {};
+
+TEST(ATResponseCacheUnitTest, RefusesCommandsAboveCapacity) {
+  ATResponseCache<1> cache;
+  EXPECT_TRUE(cache.add("AT+CSQ", 1000, nullptr));
+  EXPECT_TRUE(cache.add("AT+CSQ", 2000, nullptr));  // Re-registering updates the entry
+  EXPECT_FALSE(cache.add("AT+COPS?", 1000, nullptr));
+  EXPECT_FALSE(cache.add(std::string(AT_CACHE_COMMAND_LENGTH, 'A').c_str(), 1000, nullptr));
+  EXPECT_EQ(cache.find("AT+CSQ"), 0);
+  EXPECT_EQ(cache.find("AT+COPS?"), -1);
+  EXPECT_EQ(cache.lookup(0, 0), nullptr);
+}
+
+TEST_F(ATResponseCacheTest, AnswersRepeatedQueriesWithinTTL) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.on("AT+COPS?").reply("+COPS: 0,0,\"Operator\",7").ok();
+  modem.on("AT+CGMR").reply("BG96MAR02A07M1G").ok();
+  modem.begin();
+
+  BasicAsyncATHandler<CachingConfig> handler;
+  std::vector<String> responses;
+  bool registered = false, overflow = true;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        registered = handler.cacheCommand("AT+CSQ", 200) &&
+                     handler.cacheCommand("AT+COPS?", 60000, "+CREG:");
+        overflow = handler.cacheCommand("AT+CGMR", 60000);
+        auto query = [&](const char* command) {
+          String response;
+          if (!handler.sendSync(command, response, 1000)) {
+            throw std::runtime_error(std::string(command) + " failed");
+          }
+          responses.push_back(response);
+        };
+        query("AT+CSQ");    // Miss
+        query("AT+CSQ");    // Hit
+        query("AT+COPS?");  // Miss
+        query("AT+COPS?");  // Hit
+        vTaskDelay(pdMS_TO_TICKS(250));
+        query("AT+CSQ");  // Expired
+        modem.sendURC("+CREG: 5");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        query("AT+COPS?");  // Invalidated by the URC
+        handler.invalidateCache("AT+CSQ");
+        query("AT+CSQ");  // Invalidated explicitly
+        query("AT+CGMR");
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "CacheTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(registered);
+  EXPECT_FALSE(overflow);
+  ASSERT_EQ(responses.size(), 8u);
+  EXPECT_EQ(responses[0], "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(responses[1], responses[0]);
+  EXPECT_EQ(responses[3], responses[2]);
+  std::vector<std::string> sent = modem.receivedCommands();
+  EXPECT_EQ(
+      sent, (std::vector<std::string>{
+                "AT+CSQ", "AT+COPS?", "AT+CSQ", "AT+COPS?", "AT+CSQ", "AT+CGMR"}));
+  EXPECT_EQ(counters.cacheHits, 2u);
+  EXPECT_EQ(counters.cacheMisses, 5u);
+}
+
+TEST_F(ATResponseCacheTest, CachesQueriesAnsweredWithAURCPrefix) {
+  ModemSimulator modem;
+  modem.on("AT+CEREG?").reply("+CEREG: 2,1,\"00C3\",\"0012ABCD\",9").ok();
+  modem.begin();
+
+  BasicAsyncATHandler<CachingConfig> handler;
+  std::vector<String> responses, urcs;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.onURC([&urcs](const ATLineString& urc) { urcs.push_back(urc); });
+        handler.cacheCommand("AT+CEREG?", 60000, "+CEREG:");
+        auto query = [&]() {
+          String response;
+          if (!handler.sendSync("AT+CEREG?", response, 1000)) {
+            throw std::runtime_error("AT+CEREG? failed");
+          }
+          responses.push_back(response);
+        };
+        query();  // Miss; the +CEREG: line is the answer, not a URC
+        query();  // Hit
+        modem.sendURC("+CEREG: 5");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        query();  // Invalidated by the URC
+        handler.end();
+      },
+      "CacheCeregTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  ASSERT_EQ(responses.size(), 3u);
+  EXPECT_EQ(responses[0], "AT+CEREG?\r\n+CEREG: 2,1,\"00C3\",\"0012ABCD\",9\r\nOK\r\n");
+  EXPECT_EQ(responses[1], responses[0]);
+  EXPECT_EQ(responses[2], responses[0]);
+  EXPECT_EQ(urcs, (std::vector<String>{"+CEREG: 5\r\n"}));
+  EXPECT_EQ(modem.receivedCommands().size(), 2u);
+}
+
+TEST_F(ATResponseCacheTest, DoesNotCacheErrors) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").error("+CME ERROR: 10");
+  modem.begin();
+
+  BasicAsyncATHandler<CachingConfig> handler;
+  size_t sent = 0;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.cacheCommand("AT+CSQ", 60000);
+        for (int i = 0; i < 2; i++) {
+          if (handler.sendSync("AT+CSQ", 1000)) {
+            throw std::runtime_error("AT+CSQ should have failed");
+          }
+        }
+        sent = modem.receivedCommands().size();
+        handler.end();
+      },
+      "CacheErrorTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(sent, 2u);
+}
+
+TEST_F(ATResponseCacheTest, CoalescesIdenticalQueriesInFlight) {
+  ModemSimulator modem;
+  modem.on("AT+COPS?").latency(100000).reply("+COPS: 0,0,\"Operator\",7").ok();
+  modem.on("AT+CSQ").latency(100000).reply("+CSQ: 20,99").ok();
+  modem.on("AT+CGMR").reply("BG96MAR02A07M1G").ok();
+  modem.begin();
+
+  BasicAsyncATHandler<CoalescingConfig> handler;
+  String first, second, signal, signalAttached;
+  bool distinct = false;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        ATPromise* leader = handler.sendCommand("AT+COPS?");
+        ATPromise* attached = handler.sendCommand("AT+COPS?");
+        // No '?' and no cache, but listed in CoalescedCommands.
+        ATPromise* csq = handler.sendCommand("AT+CSQ");
+        ATPromise* csqAttached = handler.sendCommand("AT+CSQ");
+        ATPromise* revision = handler.sendCommand("AT+CGMR");  // Not listed, sent as usual
+        ATPromise* revisionAgain = handler.sendCommand("AT+CGMR");
+        if (!leader || !attached || !csq || !csqAttached || !revision || !revisionAgain) {
+          throw std::runtime_error("sendCommand failed");
+        }
+        distinct = leader->getId() != attached->getId();
+        for (ATPromise* promise : {leader, attached, csq, csqAttached, revision, revisionAgain}) {
+          if (!promise->timeout(1000)->wait()) { throw std::runtime_error("Query timed out"); }
+        }
+        first = handler.popCompletedPromise(leader->getId())->getResponse()->getFullResponse();
+        second = handler.popCompletedPromise(attached->getId())->getResponse()->getFullResponse();
+        signal = handler.popCompletedPromise(csq->getId())->getResponse()->getFullResponse();
+        signalAttached =
+            handler.popCompletedPromise(csqAttached->getId())->getResponse()->getFullResponse();
+        handler.popCompletedPromise(revision->getId());
+        handler.popCompletedPromise(revisionAgain->getId());
+        if (!handler.sendSync("AT+COPS?", 1000)) { throw std::runtime_error("AT+COPS? failed"); }
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "CoalesceTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(distinct);
+  EXPECT_EQ(first, "AT+COPS?\r\n+COPS: 0,0,\"Operator\",7\r\nOK\r\n");
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(signal, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(signalAttached, signal);
+  EXPECT_EQ(
+      modem.receivedCommands(),
+      (std::vector<std::string>{"AT+COPS?", "AT+CSQ", "AT+CGMR", "AT+CGMR", "AT+COPS?"}));
+  EXPECT_EQ(counters.coalescedCommands, 2u);
+}
+
+TEST_F(ATResponseCacheTest, AttachedQueryTakesOverWhenLeaderIsPopped) {
+  ModemSimulator modem;
+  modem.on("AT+CGATT?").latency(50000).reply("+CGATT: 1").ok();
+  modem.begin();
+
+  BasicAsyncATHandler<CoalescingConfig> handler;
+  bool success = false;
+  String response;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        ATPromise* leader = handler.sendCommand("AT+CGATT?");
+        ATPromise* attached = handler.sendCommand("AT+CGATT?");
+        if (!leader || !attached) { throw std::runtime_error("sendCommand failed"); }
+        handler.popCompletedPromise(leader->getId());  // The first caller gives up
+        success = attached->timeout(1000)->wait() && attached->getResponse()->isSuccess();
+        response = attached->getResponse()->getFullResponse();
+        handler.popCompletedPromise(attached->getId());
+        handler.end();
+      },
+      "TakeOverTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(response, "AT+CGATT?\r\n+CGATT: 1\r\nOK\r\n");
+}
+
+FREERTOS_TEST_MAIN()
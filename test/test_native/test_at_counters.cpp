@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+class ATCountersTest : public FreeRTOSTest {};
+
+TEST_F(ATCountersTest, CountsTrafficAndDrops) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.on("AT+COPS?").error("+CME ERROR: 30");
+  modem.begin();
+
+  AsyncATHandler handler;
+  int urcs = 0;
+  handler.onURC([&](const String&) { urcs++; });
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        for (int i = 0; i < 3; i++) {
+          if (!handler.sendSync("AT+CSQ", 1000)) { throw std::runtime_error("AT+CSQ failed"); }
+        }
+        handler.sendSync("AT+COPS?", 1000);
+        modem.sendURC("+CREG: 1");
+        modem.sendURC("RDY");
+        modem.sendURC(std::string(600, 'x'));
+        vTaskDelay(pdMS_TO_TICKS(100));
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "CountersTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  // Three AT+CSQ exchanges of echo, data and OK, one COPS echo and error, the URC, the orphan
+  // and the tail of the overflowing line.
+  EXPECT_EQ(counters.txBytes, 3u * 8 + 10);
+  EXPECT_EQ(counters.lines(ResponseType::FINAL_OK), 3u);
+  EXPECT_EQ(counters.lines(ResponseType::FINAL_CME_ERROR), 1u);
+  EXPECT_EQ(counters.lines(ResponseType::UNSOLICITED), 1u);
+  EXPECT_EQ(counters.urcsDispatched, 1u);
+  EXPECT_EQ(urcs, 1);
+  EXPECT_EQ(counters.lineOverflows, 1u);
+  EXPECT_EQ(counters.orphanLines, 2u);
+  EXPECT_EQ(counters.linesFramed, 3u * 3 + 2 + 3);
+  EXPECT_EQ(counters.rxBytes, 3u * (8 + 13 + 4) + 10 + 16 + 10 + 5 + 602);
+  EXPECT_EQ(counters.sendMutexTimeouts, 0u);
+  EXPECT_EQ(counters.routeMutexTimeouts, 0u);
+}
+
+FREERTOS_TEST_MAIN()
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "ATDelegate/ATDelegate.h"
+#include "AsyncATHandler.h"
+#include "allocation_counter.h"
+
+static int twice(int value) { return value * 2; }
+
+TEST(ATDelegateTest, CallsCapturingLambdaWithoutAllocating) {
+  int calls = 0, sum = 0;
+  size_t before = g_allocations;
+  ATDelegate<void(int)> callback = [&calls, &sum](int value) {
+    calls++;
+    sum += value;
+  };
+  ATDelegate<void(int)> copy = callback;
+  callback(2);
+  copy(3);
+  EXPECT_EQ(g_allocations - before, 0u);
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(sum, 5);
+}
+
+TEST(ATDelegateTest, HoldsFunctionPointersAndNull) {
+  ATDelegate<int(int)> callback;
+  EXPECT_FALSE(callback);
+  EXPECT_TRUE(callback == nullptr);
+  callback = &twice;
+  ASSERT_TRUE(callback);
+  EXPECT_EQ(callback(21), 42);
+  callback = nullptr;
+  EXPECT_FALSE(callback);
+}
+
+TEST(ATDelegateTest, NullFunctionPointerIsEmpty) {
+  int (*none)(int) = nullptr;
+  ATDelegate<int(int)> callback = none;
+  EXPECT_FALSE(callback);
+  EXPECT_TRUE(callback == nullptr);
+  ATDelegate<int(int)> copy = callback;
+  EXPECT_FALSE(copy);
+
+  void (*noHandler)(const ATLineString&) = nullptr;
+  URCCallback urc = noHandler;
+  EXPECT_FALSE(urc);
+}
+
+TEST(ATDelegateTest, CopiesMovesAndDestroysNonTrivialCaptures) {
+  auto counter = std::make_shared<int>(0);
+  {
+    ATDelegate<void()> callback = [counter]() { (*counter)++; };
+    EXPECT_EQ(counter.use_count(), 2);
+    ATDelegate<void()> copy = callback;
+    EXPECT_EQ(counter.use_count(), 3);
+    ATDelegate<void()> moved = std::move(copy);
+    EXPECT_FALSE(copy);
+    EXPECT_EQ(counter.use_count(), 3);
+    callback();
+    moved();
+    callback = nullptr;
+    EXPECT_EQ(counter.use_count(), 2);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+  EXPECT_EQ(*counter, 2);
+}
+
+TEST(ATDelegateTest, URCCallbackAcceptsStringHandlers) {
+  std::string received;
+  URCCallback callback = [&received](const String& urc) { received = urc; };
+  callback(ATLineString("+QIURC: \"recv\",0\r\n"));
+  EXPECT_EQ(received, "+QIURC: \"recv\",0\r\n");
+}
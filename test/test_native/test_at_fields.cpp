@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+#include "ATResponse/ATResponse.h"
+#include "allocation_counter.h"
+
+static ResponseLine makeLine(const char* content, ResponseType type) {
+  ResponseLine line;
+  line.content = content;
+  line.type = type;
+  line.commandId = 1;
+  line.timestamp = 0;
+  return line;
+}
+
+TEST(ATFieldsTest, ParsesSignalQuality) {
+  int rssi = -1, ber = -1;
+  EXPECT_EQ(ATFields::parse("+CSQ: 20,99\r\n", "+CSQ:", rssi, ber), 2);
+  EXPECT_EQ(rssi, 20);
+  EXPECT_EQ(ber, 99);
+}
+
+TEST(ATFieldsTest, ParsesQuotedHexRegistration) {
+  int n = 0, stat = 0, act = 0;
+  uint16_t tac = 0;
+  uint32_t ci = 0;
+  int parsed = ATFields::parse(
+      "+CEREG: 2,1,\"1A2B\",\"01A2D101\",7\r\n", "+CEREG:", n, stat, ATFields::hex(tac),
+      ATFields::hex(ci), act);
+  EXPECT_EQ(parsed, 5);
+  EXPECT_EQ(n, 2);
+  EXPECT_EQ(stat, 1);
+  EXPECT_EQ(tac, 0x1A2B);
+  EXPECT_EQ(ci, 0x01A2D101u);
+  EXPECT_EQ(act, 7);
+}
+
+TEST(ATFieldsTest, ParsesTextViewAndSkip) {
+  char service[8];
+  std::string_view ip;
+  int port = 0, state = 0;
+  int parsed = ATFields::parse(
+      "+QISTATE: 0,\"TCP\",\"220.180.239.212\",8062,0,2,0,1\r\n", "+QISTATE:", ATFields::Skip(),
+      ATFields::text(service), ip, port, ATFields::Skip(), state);
+  EXPECT_EQ(parsed, 6);
+  EXPECT_STREQ(service, "TCP");
+  EXPECT_EQ(ip, "220.180.239.212");
+  EXPECT_EQ(port, 8062);
+  EXPECT_EQ(state, 2);
+}
+
+TEST(ATFieldsTest, StopsAtMissingOrMalformedField) {
+  int a = 0, b = 0, c = 0;
+  EXPECT_EQ(ATFields::parse("+CEREG: 0,1\r\n", "+CEREG:", a, b, c), 2);
+  EXPECT_EQ(ATFields::parse("+CEREG: 0,x,4\r\n", "+CEREG:", a, b, c), 1);
+  EXPECT_EQ(ATFields::parse("+CEREG: 0,,4\r\n", "+CEREG:", a, b, c), 1);
+  EXPECT_EQ(ATFields::parse("+CSQ: 20,99\r\n", "+CEREG:", a), -1);
+}
+
+TEST(ATFieldsTest, RejectsOutOfRangeValues) {
+  uint8_t small = 0;
+  int8_t tiny = 0;
+  EXPECT_EQ(ATFields::parse("+X: 256", "+X:", small), 0);
+  EXPECT_EQ(ATFields::parse("+X: -129", "+X:", tiny), 0);
+  EXPECT_EQ(ATFields::parse("+X: -128", "+X:", tiny), 1);
+  EXPECT_EQ(tiny, -128);
+}
+
+TEST(ATFieldsTest, TruncatesTextToBuffer) {
+  char name[4];
+  EXPECT_EQ(
+      ATFields::parse(
+          "+COPS: 0,0,\"Vodafone\",7", "+COPS:", ATFields::Skip(), ATFields::Skip(),
+          ATFields::text(name)),
+      3);
+  EXPECT_STREQ(name, "Vod");
+}
+
+TEST(ATFieldsTest, ResponseScanDoesNotAllocate) {
+  ATResponse response(1);
+  response.addLine(makeLine("AT+CEREG?\r\n", ResponseType::INTERMEDIATE_DATA));
+  response.addLine(
+      makeLine("+CEREG: 2,5,\"00C3\",\"0012ABCD\",9\r\n", ResponseType::INTERMEDIATE_DATA));
+  response.addLine(makeLine("OK\r\n", ResponseType::FINAL_OK));
+
+  int stat = 0;
+  uint32_t tac = 0, ci = 0;
+  size_t before = g_allocations.load();
+  int parsed =
+      response.scan("+CEREG:", ATFields::Skip(), stat, ATFields::hex(tac), ATFields::hex(ci));
+  size_t after = g_allocations.load();
+
+  EXPECT_EQ(parsed, 4);
+  EXPECT_EQ(stat, 5);
+  EXPECT_EQ(tac, 0xC3u);
+  EXPECT_EQ(ci, 0x12ABCDu);
+  EXPECT_EQ(after, before);
+  EXPECT_EQ(response.scan("+CSQ:", stat), -1);
+}
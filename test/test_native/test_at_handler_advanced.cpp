@@ -171,12 +171,18 @@ TEST_F(AsyncATHandlerAdvancedTest, UnsolicitedResponseHandling) {
         vTaskDelay(pdMS_TO_TICKS(100));
 
         mockStream->InjectRxData("+CMT: \"+1234567890\",\"\",\"24/01/15,10:30:00\"\r\n");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        if (g_callbackCalled.load()) {
+          throw std::runtime_error("URC dispatched without its body");
+        }
+        mockStream->InjectRxData("Hello\r\n");
         vTaskDelay(pdMS_TO_TICKS(500));
 
         log_i("[Test] Checking if callback was called...");
         if (!g_callbackCalled.load()) { throw std::runtime_error("URC callback not called"); }
 
-        if (!g_unsolicitedData.startsWith("+CMT:")) {
+        if (!g_unsolicitedData.startsWith("+CMT:") ||
+            !g_unsolicitedData.endsWith("\r\nHello\r\n")) {
           throw std::runtime_error("Incorrect URC data: " + g_unsolicitedData);
         }
 
@@ -187,4 +193,33 @@ TEST_F(AsyncATHandlerAdvancedTest, UnsolicitedResponseHandling) {
   EXPECT_TRUE(testResult);
 }
 
+TEST_F(AsyncATHandlerAdvancedTest, MultiLineURCDoesNotReachPendingCommand) {
+  std::atomic<int> urcs{0};
+  String sms, response;
+  bool success = false;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler->begin(*mockStream)) throw std::runtime_error("Handler begin failed");
+        handler->onURC([&](const ATLineString& urc) {
+          sms = String(urc.c_str());
+          urcs++;
+        });
+
+        // An SMS whose text looks like a result code arrives while AT+CSQ is pending.
+        InjectDataWithDelay(
+            mockStream,
+            "AT+CSQ\r\n+CMT: \"+1234567890\",,\"24/01/15,10:30:00\"\r\nOK\r\n+CSQ: 20,99\r\nOK\r\n",
+            100);
+        success = handler->sendSync("AT+CSQ", response, 2000);
+        vTaskDelay(pdMS_TO_TICKS(100));
+      },
+      "MultiLineURCTest", configMINIMAL_STACK_SIZE * 4);
+
+  ASSERT_TRUE(testResult);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(response, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(urcs.load(), 1);
+  EXPECT_EQ(sms, "+CMT: \"+1234567890\",,\"24/01/15,10:30:00\"\r\nOK\r\n");
+}
+
 FREERTOS_TEST_MAIN()
@@ -0,0 +1,172 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "Stream.h"
+#include "common.h"
+#include "esp_log.h"
+
+using ::testing::NiceMock;
+
+class AsyncATHandlerConfigTest : public FreeRTOSTest {
+ protected:
+  void SetUp() override {
+    FreeRTOSTest::SetUp();
+    mockStream = new NiceMock<MockStream>();
+    mockStream->SetupDefaults();
+    handler = new AsyncATHandler();
+  }
+
+  void TearDown() override {
+    if (handler) {
+      while (true) {
+        auto promise = handler->popCompletedPromise(0);
+        if (!promise) {
+          break;  // No more promises to clean up
+        }
+      }
+      bool success = CleanupATHandler(handler);
+      if (!success) { log_w("Handler teardown may have failed"); }
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      delete handler;
+      handler = nullptr;
+    }
+    if (mockStream) {
+      delete mockStream;
+      mockStream = nullptr;
+    }
+    FreeRTOSTest::TearDown();
+  }
+
+ public:
+  NiceMock<MockStream>* mockStream = nullptr;
+  AsyncATHandler* handler = nullptr;
+};
+
+TEST_F(AsyncATHandlerConfigTest, CustomTaskParameters) {
+  bool testResult = runInFreeRTOSTask(
+      [this]() {
+        AsyncATHandlerConfig config;
+        config.taskName = "AT_Custom";
+        config.stackSize = configMINIMAL_STACK_SIZE * 8;
+        config.priority = 3;
+        config.coreId = 0;
+        if (!handler->begin(*mockStream, config)) {
+          throw std::runtime_error("Handler begin failed");
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        InjectDataWithDelay(mockStream, "AT\r\nOK\r\n", 100);
+        if (!handler->sendSync("AT", 2000)) {
+          throw std::runtime_error("Command failed with custom reader task");
+        }
+      },
+      "CustomTaskTest", configMINIMAL_STACK_SIZE * 4);
+
+  EXPECT_TRUE(testResult);
+}
+
+static StackType_t g_readerStack[configMINIMAL_STACK_SIZE * 8];
+static StaticTask_t g_readerTaskBuffer;
+
+TEST_F(AsyncATHandlerConfigTest, StaticTaskStorage) {
+  bool testResult = runInFreeRTOSTask(
+      [this]() {
+        AsyncATHandlerConfig config;
+        config.stackSize = configMINIMAL_STACK_SIZE * 8;
+        config.stackBuffer = g_readerStack;
+        config.taskBuffer = &g_readerTaskBuffer;
+
+        size_t freeHeapBefore = xPortGetFreeHeapSize();
+        if (!handler->begin(*mockStream, config)) {
+          throw std::runtime_error("Handler begin failed");
+        }
+        if (xPortGetFreeHeapSize() < freeHeapBefore) {
+          throw std::runtime_error("begin() allocated from the FreeRTOS heap");
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        InjectDataWithDelay(mockStream, "AT+GMR\r\nREV1\r\nOK\r\n", 100);
+        String response;
+        if (!handler->sendSync("AT+GMR", response, 2000)) {
+          throw std::runtime_error("Command failed with static reader task");
+        }
+        if (response.indexOf("REV1") == -1) {
+          throw std::runtime_error("Unexpected response: " + response);
+        }
+      },
+      "StaticTaskTest", configMINIMAL_STACK_SIZE * 4);
+
+  EXPECT_TRUE(testResult);
+}
+
+TEST_F(AsyncATHandlerConfigTest, HalfSpecifiedStaticStorageFails) {
+  bool testResult = runInFreeRTOSTask(
+      [this]() {
+        AsyncATHandlerConfig config;
+        config.stackSize = configMINIMAL_STACK_SIZE * 8;
+        config.stackBuffer = g_readerStack;
+        if (handler->begin(*mockStream, config)) {
+          throw std::runtime_error("begin() fell back to a heap task without taskBuffer");
+        }
+
+        config.stackBuffer = nullptr;
+        config.taskBuffer = &g_readerTaskBuffer;
+        if (handler->begin(*mockStream, config)) {
+          throw std::runtime_error("begin() fell back to a heap task without stackBuffer");
+        }
+
+        config.stackBuffer = g_readerStack;
+        if (!handler->begin(*mockStream, config)) {
+          throw std::runtime_error("begin() failed with both buffers");
+        }
+      },
+      "HalfStaticTest", configMINIMAL_STACK_SIZE * 4);
+
+  EXPECT_TRUE(testResult);
+}
+
+TEST_F(AsyncATHandlerConfigTest, AdaptivePollingBacksOffWhenIdle) {
+  ModemSimulator modem;
+  modem.on("AT").ok();
+  modem.begin();
+
+  AsyncATHandler adaptive;
+  ATPollStats idle, active;
+  TickType_t responseTicks = 0;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        AsyncATHandlerConfig config;
+        config.maxPollIntervalMs = 160;
+        config.activeHoldMs = 50;
+        if (!adaptive.begin(modem.stream(), config)) {
+          throw std::runtime_error("Handler begin failed");
+        }
+        vTaskDelay(pdMS_TO_TICKS(2500));
+        idle = adaptive.getPollStats();
+
+        TickType_t start = xTaskGetTickCount();
+        if (!adaptive.sendSync("AT", 1000)) { throw std::runtime_error("AT failed"); }
+        responseTicks = xTaskGetTickCount() - start;
+        active = adaptive.getPollStats();
+        adaptive.end();
+      },
+      "AdaptivePollTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_EQ(idle.intervalMs, 160u);
+  EXPECT_LT(idle.wakeupsPerSecond, 20.0f);  // Fixed 10 ms polling wakes 100 times per second
+  // sendCommand() wakes the reader instead of leaving it asleep for up to 160 ms.
+  EXPECT_LT(responseTicks, pdMS_TO_TICKS(100));
+  EXPECT_EQ(active.intervalMs, 10u);
+}
+
+FREERTOS_TEST_MAIN()
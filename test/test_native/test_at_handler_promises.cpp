@@ -6,6 +6,7 @@
 #include <iostream>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "AsyncATHandler.h"
 #include "Stream.h"
@@ -171,4 +172,101 @@ TEST_F(AsyncATHandlerPromiseTest, MultiplePromises) {
   EXPECT_TRUE(testResult);
 }
 
+// TEST 6: Information lines go to the command that answers with their prefix
+TEST_F(AsyncATHandlerPromiseTest, RoutesLinesByCommandPrefix) {
+  String activate, signal;
+  uint32_t prefixRouted = 0;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler->begin(*mockStream)) { throw std::runtime_error("Handler begin failed"); }
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        ATPromise* first = handler->sendCommand("AT+QIACT=1");
+        ATPromise* second = handler->sendCommand("AT+CSQ");
+        if (!first || !second) { throw std::runtime_error("Failed to send"); }
+
+        // The oldest command is still waiting when the later one is answered.
+        mockStream->InjectRxData("+CSQ: 20,99\r\n");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        mockStream->InjectRxData("OK\r\nOK\r\n");
+        if (!first->wait() || !second->wait()) {
+          throw std::runtime_error("Commands did not complete");
+        }
+        activate = first->getResponse()->getFullResponse();
+        signal = second->getResponse()->getFullResponse();
+        prefixRouted = handler->getCounters().prefixRoutedLines;
+      },
+      "PrefixRoutingTest", configMINIMAL_STACK_SIZE * 6);
+
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(activate, "OK\r\n");
+  EXPECT_EQ(signal, "+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(prefixRouted, 1u);
+}
+
+TEST_F(AsyncATHandlerPromiseTest, RoutesInterleavedInformationLines) {
+  String contexts, signal;
+  uint32_t prefixRouted = 0;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler->begin(*mockStream)) { throw std::runtime_error("Handler begin failed"); }
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        ATPromise* first = handler->sendCommand("AT+CGDCONT?");
+        ATPromise* second = handler->sendCommand("AT+CSQ");
+        if (!first || !second) { throw std::runtime_error("Failed to send"); }
+
+        // The answer of the later command lands between the lines of the earlier one.
+        mockStream->InjectRxData(
+            "+CGDCONT: 1,\"IP\",\"iot\"\r\n+CSQ: 20,99\r\n+CGDCONT: 2,\"IP\",\"ims\"\r\n");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        mockStream->InjectRxData("OK\r\nOK\r\n");
+        if (!first->wait() || !second->wait()) {
+          throw std::runtime_error("Commands did not complete");
+        }
+        contexts = first->getResponse()->getFullResponse();
+        signal = second->getResponse()->getFullResponse();
+        prefixRouted = handler->getCounters().prefixRoutedLines;
+      },
+      "InterleavedRoutingTest", configMINIMAL_STACK_SIZE * 6);
+
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(contexts, "+CGDCONT: 1,\"IP\",\"iot\"\r\n+CGDCONT: 2,\"IP\",\"ims\"\r\nOK\r\n");
+  EXPECT_EQ(signal, "+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(prefixRouted, 3u);
+}
+
+TEST_F(AsyncATHandlerPromiseTest, TellsQueryAnswersFromURCsWithTheirPrefix) {
+  String creg, cereg;
+  std::vector<String> urcs;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler->begin(*mockStream)) { throw std::runtime_error("Handler begin failed"); }
+        handler->onURC([&urcs](const ATLineString& urc) { urcs.push_back(urc); });
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        // Registration URCs of any shape arrive before the answers, which end each command.
+        ATPromise* first = handler->sendCommand("AT+CREG?");
+        if (!first) { throw std::runtime_error("Failed to send AT+CREG?"); }
+        mockStream->InjectRxData("+CREG: 1,0\r\n");
+        vTaskDelay(pdMS_TO_TICKS(50));
+        mockStream->InjectRxData("+CREG: 2,1\r\nOK\r\n");
+        if (!first->wait()) { throw std::runtime_error("AT+CREG? did not complete"); }
+        creg = first->getResponse()->getFullResponse();
+
+        ATPromise* second = handler->sendCommand("AT+CEREG?");
+        if (!second) { throw std::runtime_error("Failed to send AT+CEREG?"); }
+        mockStream->InjectRxData("+CEREG: 5,,,,,\r\n+CEREG: 2,1,\"00C3\",\"0012ABCD\",9\r\nOK\r\n");
+        if (!second->wait()) { throw std::runtime_error("AT+CEREG? did not complete"); }
+        cereg = second->getResponse()->getFullResponse();
+        vTaskDelay(pdMS_TO_TICKS(50));
+      },
+      "QueryAnswerTest", configMINIMAL_STACK_SIZE * 6);
+
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(creg, "+CREG: 2,1\r\nOK\r\n");
+  EXPECT_EQ(cereg, "+CEREG: 2,1,\"00C3\",\"0012ABCD\",9\r\nOK\r\n");
+  EXPECT_EQ(urcs, (std::vector<String>{"+CREG: 1,0\r\n", "+CEREG: 5,,,,,\r\n"}));
+}
+
 FREERTOS_TEST_MAIN()
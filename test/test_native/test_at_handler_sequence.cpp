@@ -254,7 +254,7 @@ TEST_F(SequenceTest, ComplexATSequenceWithURC) {
         if (response1->containsResponse("+CREG: 2")) {
           throw std::runtime_error("Step 1 failed: URC should not be in command response");
         }
-        if (response1->containsResponse("+CREG: 0,1")) {
+        if (!response1->containsResponse("+CREG: 0,1")) {
           throw std::runtime_error("Step 1 failed: Expected +CREG: 0,1 response not found");
         }
         if (!response1->containsResponse("OK")) {
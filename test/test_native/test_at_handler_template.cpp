@@ -0,0 +1,232 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "Stream.h"
+#include "common.h"
+#include "esp_log.h"
+
+using ::testing::NiceMock;
+
+struct SmallLineConfig : DefaultATHandlerConfig {
+  static constexpr size_t LineCapacity = 32;
+};
+
+struct TwoPendingConfig : DefaultATHandlerConfig {
+  static constexpr size_t MaxPendingCommands = 2;
+};
+
+struct BlockingConfig : DefaultATHandlerConfig {
+  static constexpr size_t MaxPendingCommands = 1;
+  static constexpr ATAdmissionPolicy Admission = ATAdmissionPolicy::BLOCK;
+  static constexpr uint32_t AdmissionTimeoutMs = 300;
+};
+
+struct SheddingConfig : DefaultATHandlerConfig {
+  static constexpr size_t MaxPendingCommands = 2;
+  static constexpr ATAdmissionPolicy Admission = ATAdmissionPolicy::DROP_LOW_PRIORITY;
+};
+
+struct TwoLineResponseConfig : DefaultATHandlerConfig {
+  static constexpr size_t MaxResponseLines = 2;
+};
+
+struct VendorURCs {
+  static constexpr const char* prefixes[] = {"+FOO:"};
+};
+
+struct VendorURCConfig : DefaultATHandlerConfig {
+  using URCs = VendorURCs;
+};
+
+class AsyncATHandlerTemplateTest : public FreeRTOSTest {};
+
+TEST_F(AsyncATHandlerTemplateTest, DropsLinesAboveLineCapacity) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  BasicAsyncATHandler<SmallLineConfig> handler;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        modem.sendURC(std::string(SmallLineConfig::LineCapacity - 2, 'y'));
+        modem.sendURC(std::string(SmallLineConfig::LineCapacity + 8, 'x'));
+        vTaskDelay(pdMS_TO_TICKS(50));
+        String response;
+        if (!handler.sendSync("AT+CSQ", response, 1000)) {
+          throw std::runtime_error("AT+CSQ failed after overflow");
+        }
+        if (response.indexOf("+CSQ: 20,99") == -1) {
+          throw std::runtime_error("Unexpected response");
+        }
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "LineCapacityTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(counters.lineOverflows, 1u);
+}
+
+TEST_F(AsyncATHandlerTemplateTest, RejectsCommandsAboveMaxPending) {
+  NiceMock<MockStream> stream;
+  stream.SetupDefaults();
+  BasicAsyncATHandler<TwoPendingConfig> handler;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(stream)) { throw std::runtime_error("Handler begin failed"); }
+        ATPromise* first = handler.sendCommand("AT+CSQ");
+        ATPromise* second = handler.sendCommand("AT+CREG?");
+        if (!first || !second) { throw std::runtime_error("Commands within the limit failed"); }
+        if (handler.sendCommand("AT+COPS?")) {
+          throw std::runtime_error("Third pending command was accepted");
+        }
+        if (!handler.popCompletedPromise(first->getId())) {
+          throw std::runtime_error("Pop failed");
+        }
+        if (!handler.sendCommand("AT+COPS?")) {
+          throw std::runtime_error("Command after pop was rejected");
+        }
+        handler.end();
+      },
+      "MaxPendingTest", configMINIMAL_STACK_SIZE * 4);
+  ASSERT_TRUE(testResult);
+}
+
+struct DelayedPop {
+  BasicAsyncATHandler<BlockingConfig>* handler;
+  uint32_t commandId;
+};
+
+static void popAfterDelay(void* parameter) {
+  DelayedPop* pop = static_cast<DelayedPop*>(parameter);
+  vTaskDelay(pdMS_TO_TICKS(50));
+  pop->handler->popCompletedPromise(pop->commandId);
+  vTaskDelete(nullptr);
+}
+
+TEST_F(AsyncATHandlerTemplateTest, BlockingAdmissionWaitsForFreedSlot) {
+  NiceMock<MockStream> stream;
+  stream.SetupDefaults();
+  BasicAsyncATHandler<BlockingConfig> handler;
+  ATSendResult timedOut = ATSendResult::SENT, admitted = ATSendResult::NOT_STARTED;
+  TickType_t timeoutWait = 0, admittedWait = 0;
+  ATCounterSnapshot counters;
+  DelayedPop pop{&handler, 0};
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(stream)) { throw std::runtime_error("Handler begin failed"); }
+        ATPromise* first = handler.sendCommand("AT+CSQ");
+        if (!first) { throw std::runtime_error("First command failed"); }
+
+        TickType_t start = xTaskGetTickCount();
+        handler.sendCommand("AT+CREG?", ATPriority::NORMAL, &timedOut);
+        timeoutWait = xTaskGetTickCount() - start;
+
+        pop.commandId = first->getId();
+        xTaskCreate(popAfterDelay, "Popper", configMINIMAL_STACK_SIZE * 2, &pop, 2, nullptr);
+        start = xTaskGetTickCount();
+        handler.sendCommand("AT+COPS?", ATPriority::NORMAL, &admitted);
+        admittedWait = xTaskGetTickCount() - start;
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "BlockingTest", configMINIMAL_STACK_SIZE * 4, 2, 5000);
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(timedOut, ATSendResult::ADMISSION_TIMEOUT);
+  EXPECT_GE(timeoutWait, pdMS_TO_TICKS(BlockingConfig::AdmissionTimeoutMs));
+  EXPECT_EQ(admitted, ATSendResult::SENT);
+  EXPECT_LT(admittedWait, pdMS_TO_TICKS(BlockingConfig::AdmissionTimeoutMs));
+  EXPECT_EQ(counters.admissionTimeouts, 1u);
+}
+
+TEST_F(AsyncATHandlerTemplateTest, ShedsLowPriorityCommandsFirst) {
+  NiceMock<MockStream> stream;
+  stream.SetupDefaults();
+  BasicAsyncATHandler<SheddingConfig> handler;
+  ATSendResult results[4];
+  size_t depth = 0;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(stream)) { throw std::runtime_error("Handler begin failed"); }
+        handler.sendCommand("AT+QGPSLOC=2", ATPriority::LOW, &results[0]);
+        handler.sendCommand("AT+QGPSLOC=2", ATPriority::LOW, &results[1]);
+        handler.sendCommand("AT+CSQ", ATPriority::NORMAL, &results[2]);
+        handler.sendCommand("AT+COPS?", ATPriority::NORMAL, &results[3]);
+        depth = handler.getPendingCount();
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "SheddingTest", configMINIMAL_STACK_SIZE * 4);
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(results[0], ATSendResult::SENT);
+  EXPECT_EQ(results[1], ATSendResult::DROPPED);
+  EXPECT_EQ(results[2], ATSendResult::SENT);
+  EXPECT_EQ(results[3], ATSendResult::QUEUE_FULL);
+  EXPECT_EQ(depth, 2u);
+  EXPECT_EQ(counters.admissionRejects, 2u);
+}
+
+TEST_F(AsyncATHandlerTemplateTest, KeepsFinalResultPastMaxResponseLines) {
+  ModemSimulator modem;
+  modem.on("AT+QLTS").reply("+QLTS: 1").reply("+QLTS: 2").reply("+QLTS: 3").ok();
+  modem.begin();
+
+  BasicAsyncATHandler<TwoLineResponseConfig> handler;
+  size_t lines = 0;
+  bool success = false;
+  String full;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        ATPromise* promise = handler.sendCommand("AT+QLTS");
+        if (!promise || !promise->timeout(1000)->wait()) {
+          throw std::runtime_error("AT+QLTS did not complete");
+        }
+        auto completed = handler.popCompletedPromise(promise->getId());
+        lines = completed->getResponse()->getLineCount();
+        success = completed->getResponse()->isSuccess();
+        full = completed->getResponse()->getFullResponse();
+        handler.end();
+      },
+      "RetentionTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(lines, 2u);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(full, "AT+QLTS\r\nOK\r\n");
+}
+
+TEST_F(AsyncATHandlerTemplateTest, UsesConfiguredURCSet) {
+  ModemSimulator modem;
+  modem.begin();
+
+  BasicAsyncATHandler<VendorURCConfig> handler;
+  std::vector<std::string> urcs;
+  ATCounterSnapshot counters;
+  handler.onURC([&](const String& urc) { urcs.push_back(urc); });
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        modem.sendURC("+FOO: 1");
+        modem.sendURC("+CREG: 1");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "URCSetTest", configMINIMAL_STACK_SIZE * 4);
+  modem.end();
+  ASSERT_TRUE(testResult);
+  ASSERT_EQ(urcs.size(), 1u);
+  EXPECT_EQ(urcs[0], "+FOO: 1\r\n");
+  EXPECT_EQ(counters.orphanLines, 1u);
+}
+
+FREERTOS_TEST_MAIN()
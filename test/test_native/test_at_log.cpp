@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ATLog/ATLog.h"
+#include "LoopbackStream.h"
+
+static int g_evaluations = 0;
+
+static int countEvaluation() { return ++g_evaluations; }
+
+static void collect(const ATLogRecord&, const char* message, void* context) {
+  static_cast<std::vector<std::string>*>(context)->push_back(message);
+}
+
+TEST(ATLogTest, SkipsArgumentsAboveCompiledLevel) {
+  g_evaluations = 0;
+  AT_LOGV("verbose %d", countEvaluation());
+  AT_LOGD("debug %d", countEvaluation());
+  EXPECT_EQ(g_evaluations, (AT_LOG_LEVEL >= 4) + (AT_LOG_LEVEL >= 5));
+
+  g_evaluations = 0;
+  log_d("mock debug %d", countEvaluation());
+  EXPECT_EQ(g_evaluations, LOG_LEVEL >= 4 ? 1 : 0);
+}
+
+TEST(ATLogTest, DeferredRecordsFormatLater) {
+  auto log = std::make_unique<ATDeferredLog>();
+  char command[] = "AT+CSQ";
+  log->record(3, "Sending command [%u]: %s", 7u, command);
+  command[0] = 'X';  // The record keeps its own copy
+  log->record(4, "%s=%d %.1f %zu", "a", static_cast<short>(-2), 1.5f, static_cast<size_t>(9));
+
+  std::vector<std::string> messages;
+  EXPECT_EQ(log->drain(collect, &messages), 2u);
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], "Sending command [7]: AT+CSQ");
+  EXPECT_EQ(messages[1], "a=-2 1.5 9");
+  EXPECT_EQ(log->drain(collect, &messages), 0u);
+}
+
+TEST(ATLogTest, TruncatesStringsToPayload) {
+  auto log = std::make_unique<ATDeferredLog>();
+  std::string line(200, 'x');
+  log->record(3, "[%u] %s", 1u, line.c_str());
+
+  std::vector<std::string> messages;
+  ASSERT_EQ(log->drain(collect, &messages), 1u);
+  EXPECT_EQ(messages[0], "[1] " + std::string(AT_LOG_DEFERRED_PAYLOAD - sizeof(unsigned) - 1, 'x'));
+}
+
+TEST(ATLogTest, DropsOldestWhenConsumerFallsBehind) {
+  auto log = std::make_unique<ATDeferredLog>();
+  for (int i = 0; i < AT_LOG_DEFERRED_CAPACITY + 5; i++) { log->record(2, "line %d", i); }
+
+  std::vector<std::string> messages;
+  EXPECT_EQ(log->drain(collect, &messages), static_cast<size_t>(AT_LOG_DEFERRED_CAPACITY));
+  EXPECT_EQ(log->droppedCount(), 5u);
+  EXPECT_EQ(messages.front(), "line 5");
+}
+
+TEST(ATLogTest, DrainsToStream) {
+  auto log = std::make_unique<ATDeferredLog>();
+  log->record(3, "hello %d", 1);
+  log->record(1, "failed %s", "AT+QIOPEN");
+
+  LoopbackStream capture;
+  EXPECT_EQ(log->drain(capture), 2u);
+  std::string text(capture.modem().available(), '\0');
+  capture.modem().readBytes(reinterpret_cast<uint8_t*>(&text[0]), text.size());
+  EXPECT_NE(text.find("][I] hello 1\r\n"), std::string::npos);
+  EXPECT_NE(text.find("][E] failed AT+QIOPEN\r\n"), std::string::npos);
+}
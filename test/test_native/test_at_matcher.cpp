@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "ATPromise/ATPromise.h"
+#include "ATResponse/ATMatcher.h"
+#include "allocation_counter.h"
+
+static ResponseLine makeLine(const char* content, ResponseType type) {
+  ResponseLine line;
+  line.content = content;
+  line.type = type;
+  line.commandId = 1;
+  line.timestamp = 0;
+  return line;
+}
+
+TEST(ATMatcherTest, LiteralMatchesAnywhereWithoutSyntax) {
+  ATMatcher matcher = ATMatcher::literal("*50%");
+  EXPECT_TRUE(matcher.match("+CBC: *50%\r\n"));
+  EXPECT_FALSE(matcher.match("+CBC: 50%\r\n"));
+  EXPECT_TRUE(ATMatcher::literal("").match("anything\r\n"));
+  EXPECT_TRUE(ATMatcher::literal("OK").match("SEND OK\r\n"));
+}
+
+TEST(ATMatcherTest, AnchorsSelectExactPrefixAndSuffix) {
+  EXPECT_TRUE(ATMatcher("^OK$").match("OK\r\n"));
+  EXPECT_FALSE(ATMatcher("^OK$").match("SEND OK\r\n"));
+  EXPECT_TRUE(ATMatcher("^+CSQ:").match("+CSQ: 20,99\r\n"));
+  EXPECT_FALSE(ATMatcher("^+CSQ:").match(" +CSQ: 20,99\r\n"));
+  EXPECT_TRUE(ATMatcher("SEND OK$").match("SEND OK\r\n"));
+  EXPECT_FALSE(ATMatcher("SEND$").match("SEND OK\r\n"));
+  EXPECT_TRUE(ATMatcher("%^SYSINFO:").match("^SYSINFO: 2,3\r\n"));
+  EXPECT_TRUE(ATMatcher("^costs 5%$$").match("costs 5$\r\n"));
+}
+
+TEST(ATMatcherTest, WildcardsBacktrack) {
+  ATMatcher matcher("^+QIURC: \"*\",%d$");
+  ATCaptures captures;
+  EXPECT_TRUE(matcher.match("+QIURC: \"recv\",3\r\n", &captures));
+  EXPECT_EQ(captures.number(0), 3);
+  EXPECT_FALSE(matcher.match("+QIURC: \"recv\",x\r\n"));
+  EXPECT_TRUE(ATMatcher("^a*b*c$").match("axxbyybc\r\n"));
+  EXPECT_FALSE(ATMatcher("^a*b*c$").match("axxcb\r\n"));
+}
+
+TEST(ATMatcherTest, NumbersHonourRangesAndCapture) {
+  ATMatcher matcher("^+CEREG: %d,%d[1:5]");
+  ATCaptures captures;
+  ASSERT_TRUE(matcher.match("+CEREG: 2,1,\"1A2B\",\"01A2D101\",7\r\n", &captures));
+  ASSERT_EQ(captures.size(), 2u);
+  EXPECT_EQ(captures.number(0), 2);
+  EXPECT_EQ(captures.number(1), 1);
+  EXPECT_EQ(captures.text(1), "1");
+  EXPECT_FALSE(matcher.match("+CEREG: 2,0\r\n"));
+
+  ASSERT_TRUE(ATMatcher("temp %d[-40:85]C").match("temp \"-12\"C\r\n", &captures));
+  EXPECT_EQ(captures.number(0), -12);
+  EXPECT_EQ(captures.text(0), "-12");
+  EXPECT_FALSE(ATMatcher("temp %d[-40:85]C").match("temp 90C\r\n"));
+}
+
+TEST(ATMatcherTest, FieldsCaptureTextWithoutQuotes) {
+  ATMatcher matcher("^+QISTATE: %d,%s,%s,%d");
+  ATCaptures captures;
+  std::string line = "+QISTATE: 0,\"TCP\",\"220.180.239.212\",8062,0,2\r\n";
+  ASSERT_TRUE(matcher.match(line.c_str(), line.size(), &captures));
+  line.assign(line.size(), 'x');  // Captured text is a copy
+  ASSERT_EQ(captures.size(), 4u);
+  EXPECT_EQ(captures.text(1), "TCP");
+  EXPECT_EQ(captures.text(2), "220.180.239.212");
+  EXPECT_EQ(captures.number(3), 8062);
+}
+
+TEST(ATMatcherTest, FailedMatchLeavesCapturesAlone) {
+  ATCaptures captures;
+  ASSERT_TRUE(ATMatcher("%d").match("7\r\n", &captures));
+  EXPECT_FALSE(ATMatcher("^%d,%d$").match("8,x\r\n", &captures));
+  ASSERT_EQ(captures.size(), 1u);
+  EXPECT_EQ(captures.number(0), 7);
+}
+
+TEST(ATMatcherTest, RejectsInvalidPatterns) {
+  EXPECT_FALSE(ATMatcher("%x").isValid());
+  EXPECT_FALSE(ATMatcher("%d[5:1]").isValid());
+  EXPECT_FALSE(ATMatcher("%d[1-5]").isValid());
+  EXPECT_FALSE(ATMatcher(std::string(AT_MATCHER_LENGTH + 1, 'a').c_str()).isValid());
+  EXPECT_FALSE(ATMatcher("%d").match("%d\r\n"));
+  EXPECT_FALSE(ATMatcher("%x").match("%x\r\n"));
+}
+
+TEST(ATMatcherTest, RefusesLiteralsLongerThanTheLimit) {
+  // 60 characters; the line below agrees on the first 48 and differs after that.
+  std::string expected = "+QHTTPREAD: \"https://example.com/firmware/v1.2.3/ap-a.bin\",1";
+  std::string other = "+QHTTPREAD: \"https://example.com/firmware/v1.2.3/ap-b.bin\",1\r\n";
+  ASSERT_EQ(expected.size(), 60u);
+  ASSERT_EQ(expected.compare(0, AT_MATCHER_LENGTH, other, 0, AT_MATCHER_LENGTH), 0);
+
+  ATMatcher matcher = ATMatcher::literal(expected.c_str());
+  EXPECT_FALSE(matcher.isValid());
+  EXPECT_FALSE(matcher.match(other.c_str()));
+
+  ATPromise promise(1, 1000, ATMemoryResource::defaultResource());
+  promise.expect(expected.c_str())->expect(ATMatcher("%x"));
+  EXPECT_FALSE(promise.matchesExpected(other.c_str()));
+  promise.expect("OK");
+  EXPECT_TRUE(promise.matchesExpected("OK\r\n"));  // Nothing refused sits before it
+}
+
+TEST(ATMatcherTest, MatchingDoesNotAllocate) {
+  ATMatcher matcher("^+QISTATE: %d,%s,*,%d$");
+  ATCaptures captures;
+  const char* line = "+QISTATE: 0,\"TCP\",\"220.180.239.212\",8062,0,2,0,1\r\n";
+  size_t before = g_allocations.load();
+  for (int i = 0; i < 100; i++) { EXPECT_TRUE(matcher.match(line, &captures)); }
+  EXPECT_EQ(g_allocations.load(), before);
+  EXPECT_EQ(captures.number(2), 1);
+}
+
+TEST(ATMatcherTest, PromiseCapturesExpectedFields) {
+  ATPromise promise(1, 1000, ATMemoryResource::defaultResource());
+  ATCaptures opened;
+  promise.expect("OK")->expect(ATMatcher("^+QIOPEN: %d,%d[0:0]$"), &opened);
+  EXPECT_FALSE(promise.matchesExpected("+QIOPEN: 0,0\r\n"));  // "OK" comes first
+
+  promise.addResponseLine(makeLine("OK\r\n", ResponseType::INTERMEDIATE_DATA));
+  promise.addResponseLine(makeLine("+QIOPEN: 1,565\r\n", ResponseType::UNSOLICITED));
+  EXPECT_FALSE(promise.isSettled());
+  EXPECT_TRUE(promise.matchesExpected("+QIOPEN: 1,0\r\n"));
+  promise.addResponseLine(makeLine("+QIOPEN: 1,0\r\n", ResponseType::UNSOLICITED));
+  EXPECT_TRUE(promise.isSettled());
+  ASSERT_EQ(opened.size(), 2u);
+  EXPECT_EQ(opened.number(0), 1);
+}
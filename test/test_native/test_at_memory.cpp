@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+// Budgets for a socket-heavy product: 16 reads of 400 bytes in flight.
+static const size_t kInFlight = 16;
+static const size_t kResponseBudgetBytes = 16 * 1024;
+static const size_t kLineBudgetBytes = 512;
+
+class ATMemoryTest : public FreeRTOSTest {};
+
+TEST_F(ATMemoryTest, HeavyWorkloadStaysWithinBudget) {
+  const std::string chunk(100, 'd');
+  ModemSimulator modem;
+  modem.on("AT+QIRD=*").reply(chunk).reply(chunk).reply(chunk).reply(chunk).ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATMemoryStats loaded, drained;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+
+        std::vector<ATPromise*> promises;
+        for (size_t i = 0; i < kInFlight; i++) {
+          promises.push_back(handler.sendCommand("AT+QIRD=0,400"));
+        }
+        for (ATPromise* promise : promises) {
+          if (!promise || !promise->timeout(2000)->wait()) {
+            throw std::runtime_error("Read did not complete");
+          }
+        }
+        modem.sendURC("+QIURC: \"recv\",0," + std::string(380, 'u'));
+        vTaskDelay(pdMS_TO_TICKS(50));
+        loaded = handler.getMemoryStats();
+
+        for (ATPromise* promise : promises) { handler.popCompletedPromise(promise->getId()); }
+        drained = handler.getMemoryStats();
+        handler.end();
+      },
+      "MemoryTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  // Echo, four data lines and OK per read.
+  const size_t perRead = (15 + 4 * 102 + 4) + 6 * sizeof(ResponseLine);
+  log_i(
+      "Peak: %zu promises, %zu response bytes, %zu byte line", loaded.peakPendingPromises,
+      loaded.peakResponseBytes, loaded.peakLineLength);
+
+  EXPECT_EQ(loaded.pendingPromises, kInFlight);
+  EXPECT_EQ(loaded.peakPendingPromises, kInFlight);
+  EXPECT_EQ(loaded.responseBytes, kInFlight * perRead);
+  EXPECT_LE(loaded.peakResponseBytes, kResponseBudgetBytes);
+  EXPECT_EQ(loaded.peakLineLength, 17u + 380 + 2);
+  EXPECT_LE(loaded.peakLineLength, kLineBudgetBytes);
+
+  EXPECT_EQ(drained.pendingPromises, 0u);
+  EXPECT_EQ(drained.responseBytes, 0u);
+  EXPECT_EQ(drained.peakResponseBytes, loaded.peakResponseBytes);
+#if INCLUDE_uxTaskGetStackHighWaterMark
+  EXPECT_GT(loaded.readerStackHighWaterMark, 0u);
+#endif
+}
+
+FREERTOS_TEST_MAIN()
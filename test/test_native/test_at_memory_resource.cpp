@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+// Forwards to operator new/delete and counts what is still outstanding.
+class CountingResource : public ATMemoryResource {
+ public:
+  std::atomic<size_t> allocations{0};
+  std::atomic<long> outstandingBytes{0};
+
+ protected:
+  void* doAllocate(size_t bytes, size_t alignment) override {
+    allocations++;
+    outstandingBytes += static_cast<long>(bytes);
+    return ATMemoryResource::defaultResource()->allocate(bytes, alignment);
+  }
+  void doDeallocate(void* pointer, size_t bytes, size_t alignment) override {
+    outstandingBytes -= static_cast<long>(bytes);
+    ATMemoryResource::defaultResource()->deallocate(pointer, bytes, alignment);
+  }
+};
+
+class ATMemoryResourceTest : public FreeRTOSTest {};
+
+TEST_F(ATMemoryResourceTest, HandlerAllocatesFromGivenResource) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  CountingResource resource;
+  AsyncATHandler handler(&resource);
+  size_t afterCommand = 0;
+  bool lineInResource = false;
+  std::vector<std::string> urcs;
+  handler.onURC([&](const ATLineString& urc) {
+    if (urc.getResource() == &resource) { urcs.push_back(urc.c_str()); }
+  });
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        ATPromise* promise = handler.sendCommand("AT+CSQ");
+        if (!promise || !promise->expect("+CSQ:")->timeout(1000)->wait()) {
+          throw std::runtime_error("AT+CSQ did not complete");
+        }
+        afterCommand = resource.allocations;
+        const ResponseLine* line = promise->getResponse()->findLine("+CSQ:");
+        lineInResource = line && line->content.getResource() == &resource;
+        handler.popCompletedPromise(promise->getId());
+        modem.sendURC("+CREG: 1");
+        vTaskDelay(pdMS_TO_TICKS(50));
+        handler.end();
+      },
+      "ResourceTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_GT(afterCommand, 0u);
+  EXPECT_TRUE(lineInResource);
+  ASSERT_EQ(urcs.size(), 1u);
+  EXPECT_EQ(urcs[0], "+CREG: 1\r\n");
+  EXPECT_EQ(resource.outstandingBytes.load(), 0);
+}
+
+TEST_F(ATMemoryResourceTest, ArenaIsReusableAfterReset) {
+  static unsigned char buffer[16 * 1024];
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  ATMonotonicArena arena(buffer, sizeof(buffer));
+  AsyncATHandler handler(&arena);
+  size_t usedBySession = 0;
+  int rssiAfterReset = -1;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        for (int session = 0; session < 2; session++) {
+          if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+          for (int i = 0; i < 4; i++) {
+            ATPromise* promise = handler.sendCommand("AT+CSQ");
+            if (!promise || !promise->timeout(1000)->wait()) {
+              throw std::runtime_error("AT+CSQ did not complete");
+            }
+            int ber = 0;
+            promise->getResponse()->scan("+CSQ:", rssiAfterReset, ber);
+            handler.popCompletedPromise(promise->getId());
+          }
+          handler.end();
+          usedBySession = arena.getUsedBytes();
+          arena.reset();
+        }
+      },
+      "ArenaTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_GT(usedBySession, 0u);
+  EXPECT_EQ(arena.getOverflowCount(), 0u);
+  EXPECT_EQ(arena.getUsedBytes(), 0u);
+  EXPECT_EQ(rssiAfterReset, 20);
+}
+
+TEST_F(ATMemoryResourceTest, ArenaOverflowsToUpstream) {
+  alignas(std::max_align_t) static unsigned char buffer[64];
+  CountingResource upstream;
+  ATMonotonicArena arena(buffer, sizeof(buffer), &upstream);
+
+  void* inside = arena.allocate(48);
+  void* outside = arena.allocate(48);
+  EXPECT_GE(static_cast<unsigned char*>(inside), buffer);
+  EXPECT_LT(static_cast<unsigned char*>(inside), buffer + sizeof(buffer));
+  EXPECT_EQ(arena.getOverflowCount(), 1u);
+  EXPECT_EQ(upstream.outstandingBytes.load(), 48);
+
+  arena.deallocate(inside, 48);
+  arena.deallocate(outside, 48);
+  EXPECT_EQ(upstream.outstandingBytes.load(), 0);
+  EXPECT_EQ(arena.getUsedBytes(), 48u);
+}
+
+TEST_F(ATMemoryResourceTest, StringCopiesKeepTheirResource) {
+  CountingResource resource;
+  {
+    ATResourceString line("+QIURC: \"recv\",0\r\n", 18, &resource);
+    ATResourceString copy = line;
+    ATResourceString assigned;
+    assigned = copy;
+    EXPECT_EQ(copy.getResource(), &resource);
+    EXPECT_EQ(assigned.getResource(), &resource);
+    EXPECT_TRUE(assigned == "+QIURC: \"recv\",0\r\n");
+    EXPECT_EQ(assigned.indexOf("recv"), 9);
+    EXPECT_EQ(resource.allocations.load(), 3u);
+  }
+  EXPECT_EQ(resource.outstandingBytes.load(), 0);
+}
+
+FREERTOS_TEST_MAIN()
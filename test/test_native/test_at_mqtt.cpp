@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ATMqtt/ATMqttReceiver.h"
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+class ATMqttTest : public FreeRTOSTest {};
+
+static bool decode(const std::string& line, ATMqttMessage& message) {
+  return ATMqttMessage::parse(line.data(), line.size(), message);
+}
+
+static bool complete(const std::string& line) {
+  return ATMqttMessage::isComplete(line.data(), line.size());
+}
+
+TEST_F(ATMqttTest, DecodesBothPayloadForms) {
+  ATMqttMessage message;
+  const std::string withLength("+QMTRECV: 0,7,\"cfg/led\",9,\"a\"\r\n\"b,\r\n\"\r\n");
+  ASSERT_TRUE(decode(withLength, message));
+  EXPECT_EQ(message.clientId, 0);
+  EXPECT_EQ(message.msgId, 7);
+  EXPECT_EQ(message.topic, "cfg/led");
+  EXPECT_EQ(message.payload, "a\"\r\n\"b,\r\n");
+  EXPECT_EQ(message.payload.data(), withLength.data() + 27);  // A view, not a copy
+
+  const std::string withoutLength("+QMTRECV: 1,0,\"cfg/fan\",\"on \"now\"\"\r\n");
+  ASSERT_TRUE(decode(withoutLength, message));
+  EXPECT_EQ(message.clientId, 1);
+  EXPECT_EQ(message.topic, "cfg/fan");
+  EXPECT_EQ(message.payload, "on \"now\"");
+
+  const std::string empty("+QMTRECV: 0,2,\"t\",0,\"\"\r\n");
+  ASSERT_TRUE(decode(empty, message));
+  EXPECT_TRUE(message.payload.empty());
+}
+
+TEST_F(ATMqttTest, RejectsNoticesAndOtherLines) {
+  ATMqttMessage message;
+  EXPECT_FALSE(decode("+QMTRECV: 0,3\r\n", message));  // Buffer mode notice
+  EXPECT_TRUE(complete("+QMTRECV: 0,3\r\n"));
+  EXPECT_FALSE(decode("+QMTSTAT: 0,1\r\n", message));
+  EXPECT_FALSE(decode("+QMTRECV: 0,1,\"t\",3,\"abcd\"\r\n", message));  // Length mismatch
+  EXPECT_FALSE(decode("+QMTRECV: 0,1,\"t\",\"ab\"", message));          // No line end
+}
+
+TEST_F(ATMqttTest, ReportsPayloadsThatContinueOnTheNextLine) {
+  EXPECT_FALSE(complete("+QMTRECV: 0,1,\"t\",6,\"ab\r\n"));
+  EXPECT_TRUE(complete("+QMTRECV: 0,1,\"t\",6,\"ab\r\ncd\"\r\n"));
+  EXPECT_FALSE(complete("+QMTRECV: 0,1,\"t\",\"ab\r\n"));
+  EXPECT_FALSE(complete("+QMTRECV: 0,1,\"t\",\"\r\n"));
+  EXPECT_TRUE(complete("+QMTRECV: 0,1,\"t\",\"ab\r\ncd\"\r\n"));
+  EXPECT_TRUE(complete("+QMTRECV: 0,1,\"t\",1,\"ab\"\r\n"));  // Malformed lines are not held
+  EXPECT_TRUE(complete("+CSQ: 20,99\r\n"));
+
+  // The whole message from its first line when the length is reported.
+  const std::string first("+QMTRECV: 0,1,\"t\",6,\"ab\r\n");
+  EXPECT_EQ(ATMqttMessage::frameLength(first.data(), first.size()), 30u);
+  const std::string quoted("+QMTRECV: 0,1,\"t\",\"ab\r\n");
+  EXPECT_EQ(ATMqttMessage::frameLength(quoted.data(), quoted.size()), 0u);
+}
+
+struct Delivered {
+  std::mutex mutex;
+  std::vector<std::string> config;
+  std::vector<std::string> all;
+};
+
+TEST_F(ATMqttTest, DispatchesByTopicPrefixAroundPendingCommands) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+QMTRECV: 0,2,\"cfg/b\",\"x\r\ny\"").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATMqttReceiver mqtt(handler);
+  Delivered delivered;
+  String csq;
+  bool subscribed = false, tooLong = true;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream()) || !mqtt.begin()) {
+          throw std::runtime_error("begin failed");
+        }
+        Delivered* target = &delivered;
+        int config = mqtt.subscribe("cfg/", ATMqttCallback([target](const ATMqttMessage& m) {
+          std::lock_guard<std::mutex> lock(target->mutex);
+          target->config.emplace_back(m.payload);
+        }));
+        int all = mqtt.subscribe("", ATMqttCallback([target](const ATMqttMessage& m) {
+          std::lock_guard<std::mutex> lock(target->mutex);
+          target->all.emplace_back(m.topic);
+        }));
+        subscribed = config >= 0 && all >= 0;
+        std::string longPrefix(AT_MQTT_PREFIX_LENGTH + 1, 'x');
+        tooLong = mqtt.subscribe(
+                      longPrefix.c_str(), ATMqttCallback([](const ATMqttMessage&) {})) >= 0;
+
+        ATPromise* promise = handler.sendCommand("AT+CSQ");
+        modem.sendURC("+QMTRECV: 0,1,\"cfg/a\",6,\"ab\r\ncd\"");
+        if (!promise || !promise->wait()) { throw std::runtime_error("AT+CSQ failed"); }
+        csq = promise->getResponse()->getFullResponse();
+        handler.popCompletedPromise(promise->getId());
+
+        modem.sendURC("+QMTRECV: 0,3,\"status\",\"up\"");
+        vTaskDelay(pdMS_TO_TICKS(50));
+        mqtt.unsubscribe(config);
+        modem.sendURC("+QMTRECV: 0,4,\"cfg/c\",\"z\"");
+        vTaskDelay(pdMS_TO_TICKS(50));
+        mqtt.end();
+        handler.end();
+      },
+      "MqttTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(subscribed);
+  EXPECT_FALSE(tooLong);
+  EXPECT_EQ(csq, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  // The two early messages may arrive in either order.
+  std::sort(delivered.config.begin(), delivered.config.end());
+  ASSERT_EQ(delivered.config.size(), 2u);
+  EXPECT_EQ(delivered.config[0], "ab\r\ncd");
+  EXPECT_EQ(delivered.config[1], "x\r\ny");
+  ASSERT_EQ(delivered.all.size(), 4u);
+  EXPECT_EQ(delivered.all[2], "status");
+  EXPECT_EQ(delivered.all[3], "cfg/c");
+  EXPECT_EQ(mqtt.getMessagesDispatched(), 4u);
+  EXPECT_EQ(mqtt.getMessagesUnmatched(), 0u);
+}
+
+TEST_F(ATMqttTest, FinalResultClosesTruncatedMessage) {
+  ModemSimulator modem;
+  // No closing quote before the modem moved on.
+  modem.on("AT+CSQ").reply("+QMTRECV: 0,1,\"t\",\"abc").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  std::vector<std::string> urcs;
+  String csq;
+  TickType_t elapsed = 0;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.onURC([&urcs](const ATLineString& urc) { urcs.emplace_back(urc.c_str()); });
+        TickType_t start = xTaskGetTickCount();
+        if (!handler.sendSync("AT+CSQ", csq, 2000)) { throw std::runtime_error("AT+CSQ failed"); }
+        elapsed = xTaskGetTickCount() - start;
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "MqttTruncatedTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_EQ(csq, "AT+CSQ\r\nOK\r\n");
+  EXPECT_LT(elapsed, pdMS_TO_TICKS(DefaultATHandlerConfig::URCFrameTimeoutMs));
+  EXPECT_EQ(urcs, (std::vector<std::string>{"+QMTRECV: 0,1,\"t\",\"abc\r\n"}));
+  EXPECT_EQ(counters.cutFrames, 1u);
+}
+
+TEST_F(ATMqttTest, CountedPayloadsMayHoldResultCodes) {
+  const std::string message("+QMTRECV: 0,1,\"t\",10,\"ab\r\nOK\r\ncd\"");
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply(message).reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  std::vector<std::string> urcs;
+  String csq;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.onURC([&urcs](const ATLineString& urc) { urcs.emplace_back(urc.c_str()); });
+        if (!handler.sendSync("AT+CSQ", csq, 2000)) { throw std::runtime_error("AT+CSQ failed"); }
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "MqttResultPayloadTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  // The "OK" payload line neither completes AT+CSQ nor cuts the message.
+  EXPECT_EQ(csq, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  ASSERT_EQ(urcs, (std::vector<std::string>{message + "\r\n"}));
+  ATMqttMessage decoded;
+  ASSERT_TRUE(decode(urcs[0], decoded));
+  EXPECT_EQ(decoded.payload, "ab\r\nOK\r\ncd");
+  EXPECT_EQ(counters.cutFrames, 0u);
+}
+
+TEST_F(ATMqttTest, TimeoutClosesTruncatedMessage) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  std::vector<std::string> urcs;
+  size_t urcsBeforeTimeout = 0;
+  String csq;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.onURC([&urcs](const ATLineString& urc) { urcs.emplace_back(urc.c_str()); });
+        modem.sendURC("+QMTRECV: 0,1,\"t\",\"no closing quote");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        urcsBeforeTimeout = urcs.size();
+        vTaskDelay(pdMS_TO_TICKS(DefaultATHandlerConfig::URCFrameTimeoutMs + 200));
+        if (!handler.sendSync("AT+CSQ", csq, 1000)) { throw std::runtime_error("AT+CSQ failed"); }
+        handler.end();
+      },
+      "MqttTimeoutTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_EQ(urcsBeforeTimeout, 0u);
+  EXPECT_EQ(urcs, (std::vector<std::string>{"+QMTRECV: 0,1,\"t\",\"no closing quote\r\n"}));
+  EXPECT_EQ(csq, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+}
+
+// 8 payload lines of 100 bytes each, well past LineCapacity, with or without its length.
+static std::string longMessage(bool counted) {
+  std::string payload;
+  for (int i = 0; i < 8; i++) { payload += std::string(98, 'a' + i) + "\r\n"; }
+  std::string length = counted ? std::to_string(payload.size()) + "," : "";
+  return "+QMTRECV: 0,1,\"t\"," + length + "\"" + payload + "\"";
+}
+
+TEST_F(ATMqttTest, MessagesLongerThanTheLineBufferAreDroppedWhole) {
+  std::string message = longMessage(true);
+  ModemSimulator modem;
+  modem.on("AT+CSQ").once().reply(message).reply("+CSQ: 20,99").ok();
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  std::vector<std::string> urcs;
+  String during, after;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.onURC([&urcs](const ATLineString& urc) { urcs.emplace_back(urc.c_str()); });
+        if (!handler.sendSync("AT+CSQ", during, 1000)) {
+          throw std::runtime_error("AT+CSQ during the message failed");
+        }
+        if (!handler.sendSync("AT+CSQ", after, 1000)) {
+          throw std::runtime_error("AT+CSQ after the message failed");
+        }
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "MqttOverflowTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  // The payload bytes are skipped by their count; the lines after them are routed as usual.
+  EXPECT_EQ(during, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(after, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_TRUE(urcs.empty());
+  EXPECT_EQ(counters.cutFrames, 1u);
+  EXPECT_EQ(counters.lineOverflows, 1u);
+}
+
+TEST_F(ATMqttTest, UncountedMessagesTooLongFailTheCommandTheyHide) {
+  std::string message = longMessage(false);
+  ModemSimulator modem;
+  modem.on("AT+CSQ").once().reply(message).reply("+CSQ: 20,99").ok();
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  std::vector<std::string> urcs;
+  String during, after;
+  bool duringSucceeded = true;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        handler.onURC([&urcs](const ATLineString& urc) { urcs.emplace_back(urc.c_str()); });
+        duringSucceeded = handler.sendSync("AT+CSQ", during, 1000);
+        if (!handler.sendSync("AT+CSQ", after, 1000)) {
+          throw std::runtime_error("AT+CSQ after the message failed");
+        }
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "MqttUncountedOverflowTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  // Nothing tells where the payload ends, so +CSQ: is dropped with it and AT+CSQ fails.
+  EXPECT_FALSE(duringSucceeded);
+  EXPECT_EQ(during, "AT+CSQ\r\nOK\r\n");
+  EXPECT_EQ(after, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_TRUE(urcs.empty());
+  EXPECT_EQ(counters.cutFrames, 1u);
+}
+
+FREERTOS_TEST_MAIN()
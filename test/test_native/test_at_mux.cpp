@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ATMux/ATMux.h"
+#include "AsyncATHandler.h"
+#include "MuxModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+class ATMuxTest : public FreeRTOSTest {};
+
+static std::vector<uint8_t> encode(
+    uint8_t dlci, uint8_t control, bool command, const std::string& data = "") {
+  std::vector<uint8_t> frame(data.size() + ATMuxFrame::kOverhead);
+  frame.resize(ATMuxFrame::encode(
+      frame.data(), dlci, control, command, reinterpret_cast<const uint8_t*>(data.data()),
+      data.size()));
+  return frame;
+}
+
+TEST(ATMuxFrameTest, EncodesReferenceFrames) {
+  // Channel open requests as listed in modem CMUX application notes.
+  EXPECT_EQ(
+      encode(0, ATMuxFrame::kSABM | ATMuxFrame::kPF, true),
+      (std::vector<uint8_t>{0xF9, 0x03, 0x3F, 0x01, 0x1C, 0xF9}));
+  EXPECT_EQ(
+      encode(1, ATMuxFrame::kSABM | ATMuxFrame::kPF, true),
+      (std::vector<uint8_t>{0xF9, 0x07, 0x3F, 0x01, 0xDE, 0xF9}));
+  std::vector<uint8_t> data = encode(1, ATMuxFrame::kUIH, true, "AT\r");
+  EXPECT_EQ(data.size(), 3 + ATMuxFrame::kOverhead - 1);
+  EXPECT_EQ(data[3], (3 << 1) | 1);
+}
+
+TEST(ATMuxFrameTest, DecodesFramesAndRejectsCorruptOnes) {
+  ATMuxDecoder decoder;
+  auto feed = [&decoder](const std::vector<uint8_t>& bytes, size_t& frames, size_t& errors) {
+    for (uint8_t byte : bytes) {
+      ATMuxDecoder::Result result = decoder.feed(byte);
+      if (result == ATMuxDecoder::Result::FRAME) { frames++; }
+      if (result == ATMuxDecoder::Result::ERROR) { errors++; }
+    }
+  };
+
+  size_t frames = 0, errors = 0;
+  feed(encode(2, ATMuxFrame::kUIH, false, "OK\r\n"), frames, errors);
+  ASSERT_EQ(frames, 1u);
+  EXPECT_EQ(decoder.dlci(), 2);
+  EXPECT_EQ(decoder.control(), ATMuxFrame::kUIH);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(decoder.data()), decoder.length()), "OK\r\n");
+
+  std::vector<uint8_t> corrupt = encode(1, ATMuxFrame::kUIH, false, "x");
+  corrupt[corrupt.size() - 2] ^= 0xFF;
+  feed(corrupt, frames, errors);
+  feed(encode(0, ATMuxFrame::kUA | ATMuxFrame::kPF, false), frames, errors);
+  EXPECT_EQ(errors, 1u);
+  EXPECT_EQ(frames, 2u);
+  EXPECT_EQ(decoder.control(), ATMuxFrame::kUA);
+
+  // Two length bytes announcing more than AT_MUX_FRAME_SIZE.
+  feed({0xF9, 0x05, 0xEF, 0x00, 0x02}, frames, errors);
+  EXPECT_EQ(errors, 2u);
+}
+
+TEST_F(ATMuxTest, RunsIndependentHandlersPerChannel) {
+  MuxModemSimulator modem(2);
+  modem.channel(1).on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.channel(2).on("AT+QFREAD=1,4").latency(300000).reply("CONNECT 4").reply("data").ok();
+  modem.begin();
+
+  ATMux mux;
+  AsyncATHandler control, data;
+  bool opened = false, signalBeforeRead = false, readDone = false;
+  String signal, read;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        opened = mux.begin(modem.stream(), 2);
+        if (!opened) { throw std::runtime_error("Mux begin failed"); }
+        if (!control.begin(mux.channel(1)) || !data.begin(mux.channel(2))) {
+          throw std::runtime_error("Handler begin failed");
+        }
+        ATPromise* bulk = data.sendCommand("AT+QFREAD=1,4");
+        if (!bulk) { throw std::runtime_error("AT+QFREAD failed"); }
+        if (!control.sendSync("AT+CSQ", signal, 1000)) { throw std::runtime_error("AT+CSQ"); }
+        signalBeforeRead = !bulk->isCompleted();
+        readDone = bulk->timeout(1000)->wait();
+        read = bulk->getResponse()->getFullResponse();
+        data.popCompletedPromise(bulk->getId());
+        control.end();
+        data.end();
+        mux.end();
+      },
+      "MuxTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  bool closedDown = modem.isClosedDown();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(opened);
+  EXPECT_EQ(signal, "AT+CSQ\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_TRUE(signalBeforeRead);
+  EXPECT_TRUE(readDone);
+  EXPECT_EQ(read, "AT+QFREAD=1,4\r\nCONNECT 4\r\ndata\r\nOK\r\n");
+  EXPECT_TRUE(closedDown);
+  EXPECT_EQ(mux.getFrameErrors(), 0u);
+}
+
+TEST_F(ATMuxTest, AcknowledgesModemStatusAndSurvivesCorruptFrames) {
+  MuxModemSimulator modem(1);
+  modem.channel(1).on("AT").ok();
+  modem.begin();
+
+  ATMux mux;
+  AsyncATHandler handler;
+  bool answered = false;
+  uint32_t frameErrors = 0;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!mux.begin(modem.stream(), 1)) { throw std::runtime_error("Mux begin failed"); }
+        if (!handler.begin(mux.channel(1))) { throw std::runtime_error("Handler begin failed"); }
+        modem.sendModemStatus(1);
+        modem.sendRaw(std::string("\xF9\x05\xEF\x03\x41\x00\xF9", 7));  // Wrong FCS
+        answered = handler.sendSync("AT", 1000);
+        frameErrors = mux.getFrameErrors();
+        handler.end();
+        mux.end();
+      },
+      "MuxStatusTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> responses = modem.receivedControlResponses();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(answered);
+  EXPECT_EQ(frameErrors, 1u);
+  ASSERT_GE(responses.size(), 1u);
+  EXPECT_EQ(responses[0], std::string("\xE1\x05\x07\x8D", 4));
+}
+
+TEST_F(ATMuxTest, FailsWhenTheModemRefusesAChannel) {
+  MuxModemSimulator modem(2);
+  modem.refuse(2);
+  modem.begin();
+
+  ATMux mux;
+  bool opened = true;
+  bool testResult = runInFreeRTOSTask(
+      [&]() { opened = mux.begin(modem.stream(), 2); }, "MuxRefuseTest",
+      configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+  EXPECT_FALSE(opened);
+  EXPECT_FALSE(mux.channel(1).isOpen());
+}
+
+FREERTOS_TEST_MAIN()
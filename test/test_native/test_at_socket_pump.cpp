@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ATSocket/ATSocketPump.h"
+#include "ATSocket/ATSocketStream.h"
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+class ATSocketPumpTest : public FreeRTOSTest {};
+
+struct Received {
+  std::mutex mutex;
+  std::string data;
+};
+
+template <typename Condition>
+static bool waitUntil(Condition condition, uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (!condition()) {
+    if (millis() - start > timeoutMs) { return false; }
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+  return true;
+}
+
+static size_t countCommands(const std::vector<std::string>& commands, const std::string& prefix) {
+  return std::count_if(commands.begin(), commands.end(), [&prefix](const std::string& command) {
+    return command.compare(0, prefix.size(), prefix) == 0;
+  });
+}
+
+TEST_F(ATSocketPumpTest, DrainsIntoCallbackOnRecvURC) {
+  ModemSimulator modem;
+  modem.on("AT+QIRD=0,1500").once().reply("+QIRD: 5").reply("hello").ok();
+  modem.on("AT+QIRD=0,1500").once().reply("+QIRD: 3").reply("a\r\n").ok();
+  modem.on("AT+QIRD=0,*").reply("+QIRD: 0").ok();
+  modem.on("AT+QSSLRECV=0,*").reply("+QSSLRECV: 0").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATSocketPump pump(handler);
+  Received received;
+  bool added = false, duplicateRejected = false, delivered = false, drained = false;
+  bool otherTypeIgnored = false;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream()) || !pump.begin()) {
+          throw std::runtime_error("begin failed");
+        }
+        Received* target = &received;
+        ATDataCallback sink([target](const uint8_t* data, size_t length) {
+          std::lock_guard<std::mutex> lock(target->mutex);
+          target->data.append(reinterpret_cast<const char*>(data), length);
+        });
+        added = pump.add(0, ATSocketType::TCP, sink);
+        duplicateRejected = !pump.add(0, ATSocketType::TCP, sink);
+
+        modem.sendURC("+QSSLURC: \"recv\",0");  // Not added for TLS
+        modem.sendURC("+QIURC: \"recv\",0");
+        delivered = waitUntil([&pump]() { return pump.getBytesDelivered() == 8; }, 1000);
+        drained = waitUntil(
+            [&pump]() { return !pump.hasPendingData(0, ATSocketType::TCP); }, 1000);
+        otherTypeIgnored = !pump.hasPendingData(0, ATSocketType::TLS);
+        pump.remove(0, ATSocketType::TCP);
+        pump.end();
+        handler.end();
+      },
+      "PumpTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> commands = modem.receivedCommands();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(added);
+  EXPECT_TRUE(duplicateRejected);
+  EXPECT_TRUE(delivered);
+  EXPECT_TRUE(drained);
+  EXPECT_TRUE(otherTypeIgnored);
+  EXPECT_EQ(received.data, "helloa\r\n");
+  EXPECT_EQ(countCommands(commands, "AT+QIRD=0,"), 3u);
+  EXPECT_EQ(countCommands(commands, "AT+QSSLRECV"), 0u);
+}
+
+TEST_F(ATSocketPumpTest, FillsStreamBufferAndResumesWhenRead) {
+  const std::string first(1500, 'x');
+  const std::string second(AT_SOCKET_RX_BUFFER - 1500, 'y');
+  ModemSimulator modem;
+  modem.on("AT+QIOPEN=*").ok().urc("+QIOPEN: 0,0", 1000);
+  modem.on("AT+QIRD=0,1500").once().reply("+QIRD: 1500").reply(first).ok();
+  modem.on("AT+QIRD=0," + std::to_string(second.size()))
+      .once()
+      .reply("+QIRD: " + std::to_string(second.size()))
+      .reply(second)
+      .ok();
+  modem.on("AT+QIRD=0,*").reply("+QIRD: 0").ok();
+  modem.on("AT+QICLOSE=0").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATSocketPump pump(handler);
+  ATSocketStream socket(handler, 0);
+  bool connected = false, filled = false, resumed = false;
+  uint32_t streamReads = 0;
+  std::string data;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream()) || !pump.begin()) {
+          throw std::runtime_error("begin failed");
+        }
+        socket.setPump(&pump);
+        connected = socket.connect("example.com", 80);
+        modem.sendURC("+QIURC: \"recv\",0");
+        filled = waitUntil(
+            [&socket]() { return socket.available() == AT_SOCKET_RX_BUFFER; }, 1000);
+
+        uint8_t buffer[256];
+        while (size_t count = socket.read(buffer, sizeof(buffer))) {
+          data.append(reinterpret_cast<char*>(buffer), count);
+        }
+        // The pump retries once there is room and finds the modem buffer empty.
+        resumed = waitUntil(
+            [&pump]() { return !pump.hasPendingData(0, ATSocketType::TCP); }, 1000);
+        streamReads = socket.getReadCommands();
+        socket.stop();
+        pump.end();
+        handler.end();
+      },
+      "PumpStreamTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> commands = modem.receivedCommands();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(connected);
+  EXPECT_TRUE(filled);
+  EXPECT_TRUE(resumed);
+  EXPECT_EQ(data, first + second);
+  EXPECT_EQ(streamReads, 0u);
+  EXPECT_EQ(countCommands(commands, "AT+QIRD=0," + std::to_string(second.size())), 1u);
+  EXPECT_GE(countCommands(commands, "AT+QIRD=0,"), 3u);
+}
+
+FREERTOS_TEST_MAIN()
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "ATSocket/ATSocketStream.h"
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+class ATSocketStreamTest : public FreeRTOSTest {};
+
+// Socket data with line ends, a result code and a NUL that must not end the read early.
+static const std::string kBinary("ab\r\nOK\r\n\0z", 10);
+
+static bool waitForData(ATSocketStream& socket, uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (!socket.available()) {
+    if (millis() - start > timeoutMs) { return false; }
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+  return true;
+}
+
+TEST_F(ATSocketStreamTest, CoalescesWritesAndReadsAhead) {
+  ModemSimulator modem;
+  modem.on("AT+QIOPEN=1,0,\"TCP\",\"example.com\",80,0,0").ok().urc("+QIOPEN: 0,0", 1000);
+  modem.on("AT+QISEND=0,*").payload().final("SEND OK");
+  modem.on("AT+QIRD=0,1500").once().reply("+QIRD: 10").reply(kBinary).ok();
+  modem.on("AT+QIRD=0,*").reply("+QIRD: 0").ok();
+  modem.on("AT+QICLOSE=0").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATSocketStream socket(handler, 0);
+  bool connected = false, gotData = false, drained = false;
+  uint32_t sendsBeforeFlush = 0, sendsAfterFlush = 0, readsAfterData = 0, readsAfterDrain = 0;
+  std::string received;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        connected = socket.connect("example.com", 80);
+        socket.print(String("GET / HTTP/1.1\r\n"));
+        socket.print(String("Host: example.com\r\n"));
+        socket.print(String("\r\n"));
+        sendsBeforeFlush = socket.getSendCommands();
+        socket.flush();
+        sendsAfterFlush = socket.getSendCommands();
+
+        modem.sendURC("+QIURC: \"recv\",0");
+        gotData = waitForData(socket, 1000);
+        readsAfterData = socket.getReadCommands();
+        for (int c; (c = socket.read()) >= 0;) { received += static_cast<char>(c); }
+        readsAfterDrain = socket.getReadCommands();
+        drained = socket.available() == 0 && socket.connected();
+        socket.stop();
+        handler.end();
+      },
+      "SocketTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> payloads = modem.receivedPayloads();
+  std::vector<std::string> commands = modem.receivedCommands();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(connected);
+  EXPECT_EQ(sendsBeforeFlush, 0u);
+  EXPECT_EQ(sendsAfterFlush, 1u);
+  ASSERT_EQ(payloads.size(), 1u);
+  EXPECT_EQ(payloads[0], "GET / HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  EXPECT_TRUE(gotData);
+  EXPECT_EQ(readsAfterData, 1u);
+  EXPECT_EQ(received, kBinary);
+  EXPECT_EQ(readsAfterDrain, 2u);  // The second read found the modem buffer empty
+  EXPECT_TRUE(drained);
+  ASSERT_FALSE(commands.empty());
+  EXPECT_EQ(commands.back(), "AT+QICLOSE=0");
+}
+
+TEST_F(ATSocketStreamTest, TLSSocketKeepsUnreadDataAfterClose) {
+  ModemSimulator modem;
+  modem.on("AT+QSSLOPEN=1,2,1,\"broker.example\",8883,0").ok().urc("+QSSLOPEN: 1,0", 1000);
+  modem.on("AT+QSSLRECV=1,*").once().reply("+QSSLRECV: 4").reply("ping").ok();
+  modem.on("AT+QSSLRECV=1,*").reply("+QSSLRECV: 0").ok();
+  modem.on("AT+QSSLCLOSE=1").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATSocketConfig config;
+  config.sslContextId = 2;
+  ATSocketStream socket(handler, 1, config);
+  bool connected = false, openAfterClosed = true, connectedWithData = false, gotData = false;
+  bool connectedAfterRead = true;
+  std::string received;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        connected = socket.connect("broker.example", 8883, ATSocketType::TLS);
+        modem.sendURC("+QSSLURC: \"recv\",1");
+        modem.sendURC("+QSSLURC: \"closed\",1");
+        vTaskDelay(pdMS_TO_TICKS(50));
+        openAfterClosed = socket.write(reinterpret_cast<const uint8_t*>("x"), 1) == 1;
+        connectedWithData = socket.connected();
+        gotData = waitForData(socket, 1000);
+        uint8_t buffer[16];
+        size_t count = socket.read(buffer, sizeof(buffer));
+        received.assign(reinterpret_cast<char*>(buffer), count);
+        socket.available();  // Finds the modem buffer empty
+        connectedAfterRead = socket.connected();
+        socket.stop();
+        handler.end();
+      },
+      "SocketTLSTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> commands = modem.receivedCommands();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(connected);
+  EXPECT_FALSE(openAfterClosed);
+  EXPECT_TRUE(connectedWithData);
+  EXPECT_TRUE(gotData);
+  EXPECT_EQ(received, "ping");
+  EXPECT_FALSE(connectedAfterRead);
+  ASSERT_FALSE(commands.empty());
+  EXPECT_EQ(commands.back(), "AT+QSSLCLOSE=1");
+}
+
+TEST_F(ATSocketStreamTest, ConnectFailsAndReleasesTheSocketOnOpenError) {
+  ModemSimulator modem;
+  modem.on("AT+QIOPEN=*").ok().urc("+QIOPEN: 0,565", 1000);
+  modem.on("AT+QICLOSE=0").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATSocketStream socket(handler, 0);
+  bool connected = true;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        connected = socket.connect("unreachable.example", 80);
+        handler.end();
+      },
+      "SocketFailTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> commands = modem.receivedCommands();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_FALSE(connected);
+  EXPECT_FALSE(socket.connected());
+  ASSERT_EQ(commands.size(), 2u);
+  EXPECT_EQ(commands[1], "AT+QICLOSE=0");
+}
+
+TEST_F(ATSocketStreamTest, HandlerStoresDataBlocksVerbatimAndNotifiesListeners) {
+  ModemSimulator modem;
+  modem.on("AT+QIRD=0,100").reply("+QIRD: 6").reply("ab\r\nOK").ok();
+  modem.on("AT+QISEND=0,3").payload().final("SEND FAIL");
+  modem.begin();
+
+  AsyncATHandler handler;
+  String block;
+  bool blockOk = false, sendFailed = false;
+  int first = -1, second = -1;
+  std::atomic<int> firstCalls{0}, secondCalls{0};
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        first = handler.addURCListener(URCListener([&firstCalls](const char* line, size_t) {
+          if (strncmp(line, "+QIURC:", 7) == 0) { firstCalls++; }
+        }));
+        second = handler.addURCListener(
+            URCListener([&secondCalls](const char*, size_t) { secondCalls++; }));
+        modem.sendURC("+QIURC: \"recv\",0");
+
+        ATPromise* read = handler.sendCommand("AT+QIRD=0,100");
+        if (!read || !read->wait()) { throw std::runtime_error("AT+QIRD failed"); }
+        blockOk = read->getResponse()->isSuccess();
+        block = read->getResponse()->getFullResponse();
+        handler.popCompletedPromise(read->getId());
+
+        ATPromise* send = handler.sendWithPayload(
+            "AT+QISEND=0,3", reinterpret_cast<const uint8_t*>("abc"), 3, 1000);
+        if (!send || !send->wait()) { throw std::runtime_error("AT+QISEND failed"); }
+        sendFailed = send->getResponse()->isCompleted() && !send->getResponse()->isSuccess();
+        handler.popCompletedPromise(send->getId());
+
+        handler.removeURCListener(second);
+        modem.sendURC("+QIURC: \"closed\",0");
+        vTaskDelay(pdMS_TO_TICKS(50));
+        handler.end();
+      },
+      "SocketBlockTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  std::vector<std::string> payloads = modem.receivedPayloads();
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  EXPECT_TRUE(blockOk);
+  EXPECT_EQ(block, "AT+QIRD=0,100\r\n+QIRD: 6\r\nab\r\nOK\r\nOK\r\n");
+  EXPECT_TRUE(sendFailed);
+  ASSERT_EQ(payloads.size(), 1u);
+  EXPECT_EQ(payloads[0], "abc");
+  EXPECT_GE(first, 0);
+  EXPECT_GE(second, 0);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(firstCalls.load(), 2);
+  EXPECT_EQ(secondCalls.load(), 1);
+}
+
+TEST_F(ATSocketStreamTest, DropsDataBlocksNoCommandAskedFor) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+QIRD: 6").reply("ab\r\nOK").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  String signal;
+  ATCounterSnapshot counters;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        // A stray block arrives while an unrelated command is pending.
+        if (!handler.sendSync("AT+CSQ", signal, 1000)) {
+          throw std::runtime_error("AT+CSQ failed");
+        }
+        counters = handler.getCounters();
+        handler.end();
+      },
+      "SocketStrayBlockTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  // Only the line end that follows the block is left over.
+  EXPECT_EQ(signal, "AT+CSQ\r\n\r\n+CSQ: 20,99\r\nOK\r\n");
+  EXPECT_EQ(counters.droppedBlockBytes, 6u);
+}
+
+FREERTOS_TEST_MAIN()
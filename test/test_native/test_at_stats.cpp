@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+TEST(ATLatencyHistogramTest, PercentilesWithinBucketResolution) {
+  ATLatencyHistogram histogram;
+  for (uint32_t i = 1; i <= 1000; i++) { histogram.record(i * 100); }
+
+  ATLatencySummary summary;
+  histogram.summarize(summary);
+  EXPECT_EQ(histogram.count(), 1000u);
+  EXPECT_EQ(summary.max, 100000u);
+  EXPECT_GE(summary.p50, 50000u);
+  EXPECT_LE(summary.p50, 50000u * 5 / 4);
+  EXPECT_GE(summary.p99, 99000u);
+  EXPECT_LE(summary.p99, 100000u);
+}
+
+TEST(ATStatsTest, GroupsByPrefixAndOverflows) {
+  ATStats stats;
+  int csq = stats.slotFor("AT+CSQ");
+  EXPECT_EQ(stats.slotFor("AT+QIOPEN=1,0,\"TCP\""), stats.slotFor("AT+QIOPEN?"));
+  EXPECT_EQ(stats.slotFor("AT+CSQ"), csq);
+  for (int i = 0; i < AT_STATS_MAX_COMMANDS; i++) { stats.slotFor(("AT+X" + String(i)).c_str()); }
+
+  EXPECT_EQ(stats.size(), static_cast<size_t>(AT_STATS_MAX_COMMANDS));
+  ATCommandStats entry;
+  ASSERT_TRUE(stats.get(AT_STATS_MAX_COMMANDS - 1, entry));
+  EXPECT_STREQ(entry.prefix, "*");
+  EXPECT_EQ(stats.find("AT+QIOPEN"), 1);
+}
+
+class ATStatsHandlerTest : public FreeRTOSTest {};
+
+TEST_F(ATStatsHandlerTest, ReportsPerCommandLatency) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").latency(5000).reply("+CSQ: 20,99").ok();
+  modem.on("AT+QIACT=1").latency(40000).ok();
+  modem.on("AT+COPS?").error("+CME ERROR: 30");
+  modem.on("AT+QPOWD").latency(300000).ok();
+  modem.setEcho(false);
+  modem.begin();
+
+  AsyncATHandler handler;
+  ATCommandStats csq, qiact, cops, qpowd;
+  ATCommandStats all[AT_STATS_MAX_COMMANDS];
+  size_t entries = 0;
+  bool clearedByReset = false;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        for (int i = 0; i < 10; i++) {
+          if (!handler.sendSync("AT+CSQ", 1000)) { throw std::runtime_error("AT+CSQ failed"); }
+        }
+        if (!handler.sendSync("AT+QIACT=1", 1000)) { throw std::runtime_error("QIACT failed"); }
+        handler.sendSync("AT+COPS?", 1000);
+        handler.sendSync("AT+QPOWD", 50);
+
+        if (!handler.getStats("AT+CSQ", csq) || !handler.getStats("AT+QIACT", qiact) ||
+            !handler.getStats("AT+COPS", cops) || !handler.getStats("AT+QPOWD", qpowd)) {
+          throw std::runtime_error("Missing command stats");
+        }
+        entries = handler.getStats(all, AT_STATS_MAX_COMMANDS);
+        handler.resetStats();
+        clearedByReset = !handler.getStats("AT+CSQ", csq);
+        handler.end();
+      },
+      "StatsTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  log_i(
+      "AT+CSQ final: p50 %u us, p99 %u us, max %u us", all[0].final.p50, all[0].final.p99,
+      all[0].final.max);
+  EXPECT_EQ(entries, 4u);
+  EXPECT_STREQ(all[0].prefix, "AT+CSQ");
+  EXPECT_EQ(all[0].completed, 10u);
+  EXPECT_GE(all[0].final.p50, 5000u);
+  EXPECT_LE(all[0].firstLine.max, all[0].final.max);
+  EXPECT_GE(qiact.final.max, 40000u);
+  EXPECT_EQ(cops.errors, 1u);
+  EXPECT_EQ(qpowd.timeouts, 1u);
+  EXPECT_TRUE(clearedByReset);
+}
+
+FREERTOS_TEST_MAIN()
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+TEST(ATTraceTest, KeepsMostRecentEventsOldestFirst) {
+  ATTrace trace;
+  for (uint32_t i = 1; i <= AT_TRACE_CAPACITY + 10; i++) {
+    trace.record(ATTraceEventType::LINE_FRAMED, i, static_cast<uint16_t>(i));
+  }
+
+  std::vector<ATTraceEvent> events(AT_TRACE_CAPACITY);
+  ASSERT_EQ(trace.snapshot(events.data(), events.size()), static_cast<size_t>(AT_TRACE_CAPACITY));
+  EXPECT_EQ(trace.recorded(), AT_TRACE_CAPACITY + 10u);
+  EXPECT_EQ(events.front().sequence, 11u);
+  EXPECT_EQ(events.back().id, AT_TRACE_CAPACITY + 10u);
+  for (size_t i = 1; i < events.size(); i++) {
+    EXPECT_EQ(events[i].sequence, events[i - 1].sequence + 1);
+  }
+
+  ATTraceEvent latest[4];
+  ASSERT_EQ(trace.snapshot(latest, 4), 4u);
+  EXPECT_EQ(latest[3].id, AT_TRACE_CAPACITY + 10u);
+}
+
+TEST(ATTraceTest, ConcurrentWritersNeverYieldTornEvents) {
+  ATTrace trace;
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> writers;
+  for (uint32_t writer = 1; writer <= 4; writer++) {
+    writers.emplace_back([&, writer]() {
+      for (uint16_t i = 0; !stop.load(); i++) {
+        trace.record(
+            ATTraceEventType::LINE_ROUTED, writer, i, static_cast<uint8_t>((writer * 31) ^ i));
+      }
+    });
+  }
+
+  while (trace.recorded() < AT_TRACE_CAPACITY) { std::this_thread::yield(); }
+  std::vector<ATTraceEvent> events(AT_TRACE_CAPACITY);
+  size_t checked = 0;
+  for (int round = 0; round < 2000; round++) {
+    size_t count = trace.snapshot(events.data(), events.size());
+    for (size_t i = 0; i < count; i++) {
+      const ATTraceEvent& event = events[i];
+      ASSERT_EQ(event.detail, static_cast<uint8_t>((event.id * 31) ^ event.length));
+    }
+    checked += count;
+  }
+  stop = true;
+  for (auto& writer : writers) { writer.join(); }
+  EXPECT_GT(checked, 0u);
+}
+
+#if AT_TRACE_ENABLED
+class ATTraceHandlerTest : public FreeRTOSTest {};
+
+TEST_F(ATTraceHandlerTest, TracesCommandLifecycle) {
+  ModemSimulator modem;
+  modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+  modem.begin();
+
+  AsyncATHandler handler;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        if (!handler.sendSync("AT+CSQ", 1000)) { throw std::runtime_error("AT+CSQ failed"); }
+        handler.end();
+      },
+      "TraceTest", configMINIMAL_STACK_SIZE * 4, 2, 5000);
+  modem.end();
+  ASSERT_TRUE(testResult);
+
+  std::vector<ATTraceEvent> events(AT_TRACE_CAPACITY);
+  events.resize(handler.getTrace().snapshot(events.data(), events.size()));
+  std::vector<ATTraceEventType> types;
+  for (const auto& event : events) { types.push_back(static_cast<ATTraceEventType>(event.type)); }
+
+  // Echo, data line and OK are each framed, classified and routed before the promise settles.
+  std::vector<ATTraceEventType> expected = {ATTraceEventType::COMMAND_SENT};
+  for (int i = 0; i < 3; i++) {
+    expected.push_back(ATTraceEventType::LINE_FRAMED);
+    expected.push_back(ATTraceEventType::LINE_CLASSIFIED);
+    expected.push_back(ATTraceEventType::LINE_ROUTED);
+  }
+  expected.push_back(ATTraceEventType::PROMISE_SETTLED);
+  EXPECT_EQ(types, expected);
+  EXPECT_EQ(events.back().id, 1u);
+  EXPECT_EQ(events.back().detail, 1);
+
+  LoopbackStream capture;
+  EXPECT_EQ(handler.getTrace().dump(capture), events.size());
+  std::string text(capture.modem().available(), '\0');
+  capture.modem().readBytes(reinterpret_cast<uint8_t*>(&text[0]), text.size());
+  EXPECT_EQ(text.rfind(AT_TRACE_DUMP_MAGIC " 1 11\r\n", 0), 0u);
+  EXPECT_NE(text.find(AT_TRACE_DUMP_MAGIC " END"), std::string::npos);
+}
+#endif
+
+FREERTOS_TEST_MAIN()
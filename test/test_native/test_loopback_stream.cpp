@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncATHandler.h"
+#include "LoopbackStream.h"
+#include "common.h"
+#include "esp_log.h"
+
+TEST(ATRingBufferTest, WrapsAroundAndReportsSpace) {
+  ATRingBuffer<8> ring;
+  uint8_t out[8];
+  const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+  const uint8_t second[] = {7, 8, 9, 10, 11};
+
+  EXPECT_EQ(ring.write(first, sizeof(first)), 6u);
+  EXPECT_EQ(ring.read(out, 4), 4u);
+  EXPECT_EQ(ring.write(second, sizeof(second)), 5u);
+  EXPECT_EQ(ring.space(), 1u);
+  EXPECT_FALSE(ring.push(12) && ring.push(13));
+  EXPECT_EQ(ring.peek(), 5);
+
+  EXPECT_EQ(ring.read(out, sizeof(out)), 8u);
+  const uint8_t expected[] = {5, 6, 7, 8, 9, 10, 11, 12};
+  EXPECT_EQ(memcmp(out, expected, sizeof(expected)), 0);
+  EXPECT_EQ(ring.pop(), -1);
+}
+
+TEST(LoopbackStreamTest, StreamsMegabytesInOrder) {
+  LoopbackStream stream;
+  const size_t totalBytes = 8 * 1024 * 1024;
+  std::atomic<bool> mismatch{false};
+
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    std::vector<uint8_t> chunk(1500);
+    size_t sent = 0;
+    while (sent < totalBytes) {
+      for (size_t i = 0; i < chunk.size(); i++) { chunk[i] = static_cast<uint8_t>(sent + i); }
+      size_t size = totalBytes - sent < chunk.size() ? totalBytes - sent : chunk.size();
+      sent += stream.modem().write(chunk.data(), size);
+    }
+  });
+
+  size_t received = 0;
+  std::vector<uint8_t> buffer(4096);
+  while (received < totalBytes) {
+    size_t count = stream.readBytes(buffer.data(), buffer.size());
+    for (size_t i = 0; i < count; i++) {
+      if (buffer[i] != static_cast<uint8_t>(received + i)) { mismatch = true; }
+    }
+    received += count;
+    if (count == 0) { std::this_thread::yield(); }
+  }
+  producer.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  log_i("Loopback throughput: %.1f MB/s", totalBytes / seconds / (1024.0 * 1024.0));
+  EXPECT_FALSE(mismatch.load());
+  EXPECT_EQ(stream.available(), 0);
+}
+
+class LoopbackHandlerTest : public FreeRTOSTest {};
+
+TEST_F(LoopbackHandlerTest, HandlerRoundTripOverLoopback) {
+  LoopbackStream stream;
+  AsyncATHandler handler;
+  std::atomic<bool> stop{false};
+
+  // Answers every command line with its echo and OK.
+  std::thread modem([&]() {
+    std::string line;
+    while (!stop.load()) {
+      int c = stream.modem().read();
+      if (c < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      line += static_cast<char>(c);
+      if (line.size() >= 2 && line.compare(line.size() - 2, 2, "\r\n") == 0) {
+        stream.modem().print(String(line + "OK\r\n"));
+        line.clear();
+      }
+    }
+  });
+
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(stream)) { throw std::runtime_error("Handler begin failed"); }
+        for (int i = 0; i < 20; i++) {
+          String response;
+          if (!handler.sendSync("AT+CSQ", response, 1000)) {
+            throw std::runtime_error("Command failed over loopback");
+          }
+          if (response != "AT+CSQ\r\nOK\r\n") {
+            throw std::runtime_error("Unexpected response: " + response);
+          }
+        }
+        handler.end();
+      },
+      "LoopbackTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+
+  stop = true;
+  modem.join();
+  EXPECT_TRUE(testResult);
+}
+
+FREERTOS_TEST_MAIN()
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "AsyncATHandler.h"
+#include "ModemSimulator.h"
+#include "common.h"
+#include "esp_log.h"
+
+class ModemSimulatorTest : public FreeRTOSTest {
+ protected:
+  void SetUp() override {
+    FreeRTOSTest::SetUp();
+    modem.on("AT").ok();
+    modem.on("AT+CPIN?").reply("+CPIN: READY").ok();
+    modem.on("AT+CSQ").reply("+CSQ: 20,99").ok();
+    modem.on("AT+CEREG?").reply("+CEREG: 0,1").ok();
+    modem.on("AT+QIACT=1").latency(20000).ok();
+    modem.on("AT+QIOPEN=*").ok().urc("+QIOPEN: 0,0", 50000);
+    modem.on("AT+QISEND=*").payload().final("SEND OK");
+    modem.on("AT+COPS?").error("+CME ERROR: 30");
+  }
+
+  void TearDown() override {
+    modem.end();
+    FreeRTOSTest::TearDown();
+  }
+
+ public:
+  ModemSimulator modem{ModemSimulator::Timing{115200, 2000, 1000}};
+};
+
+TEST_F(ModemSimulatorTest, QuectelSocketSession) {
+  std::atomic<bool> opened{false};
+  AsyncATHandler handler;
+  handler.onURC([&](const String& urc) {
+    if (urc.indexOf("+QIOPEN: 0,0") != -1) { opened = true; }
+  });
+  modem.begin();
+
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+
+        String response;
+        if (!handler.sendSync("AT+CPIN?", response, 1000) || response.indexOf("READY") == -1) {
+          throw std::runtime_error("SIM not ready: " + response);
+        }
+        if (!handler.sendSync("AT+CEREG?", 1000)) {
+          throw std::runtime_error("Registration query failed");
+        }
+        if (!handler.sendSync("AT+QIACT=1", 1000)) {
+          throw std::runtime_error("PDP activation failed");
+        }
+        if (!handler.sendSync("AT+QIOPEN=1,0,\"TCP\",\"10.0.0.1\",80,0,0", 1000)) {
+          throw std::runtime_error("Socket open failed");
+        }
+        for (int i = 0; i < 100 && !opened.load(); i++) { vTaskDelay(pdMS_TO_TICKS(10)); }
+        if (!opened.load()) { throw std::runtime_error("No +QIOPEN URC"); }
+
+        if (handler.sendSync("AT+COPS?", 1000)) {
+          throw std::runtime_error("CME error reported as success");
+        }
+        if (handler.sendSync("AT+UNKNOWN", 1000)) {
+          throw std::runtime_error("Unknown command reported as success");
+        }
+
+        // Prompt promises stay pending in the handler, so the payload exchange goes last.
+        const char payload[] = "HELLO";
+        ATPromise* prompt = handler.sendCommand("AT+QISEND=0,5");
+        if (!prompt || !prompt->expect(">")->wait()) {
+          throw std::runtime_error("No send prompt");
+        }
+        handler.getStream()->write(reinterpret_cast<const uint8_t*>(payload), 5);
+        ATPromise* sent = handler.sendCommand("");
+        if (!sent || !sent->expect("SEND OK")->wait()) {
+          throw std::runtime_error("No SEND OK");
+        }
+        handler.end();
+      },
+      "SessionTest", configMINIMAL_STACK_SIZE * 4, 2, 10000);
+
+  EXPECT_TRUE(testResult);
+  std::vector<std::string> commands = modem.receivedCommands();
+  ASSERT_EQ(commands.size(), 7u);
+  EXPECT_EQ(commands.front(), "AT+CPIN?");
+  EXPECT_EQ(commands[4], "AT+COPS?");
+  EXPECT_EQ(commands.back(), "AT+QISEND=0,5");
+}
+
+TEST_F(ModemSimulatorTest, CommandLatencyPercentiles) {
+  AsyncATHandler handler;
+  std::vector<double> latenciesMs;
+  modem.begin();
+
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(modem.stream())) { throw std::runtime_error("Handler begin failed"); }
+        for (int i = 0; i < 200; i++) {
+          auto start = std::chrono::steady_clock::now();
+          if (!handler.sendSync("AT+CSQ", 1000)) { throw std::runtime_error("AT+CSQ failed"); }
+          latenciesMs.push_back(
+              std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                  .count());
+        }
+        handler.end();
+      },
+      "LatencyTest", configMINIMAL_STACK_SIZE * 4, 2, 30000);
+
+  ASSERT_TRUE(testResult);
+  std::sort(latenciesMs.begin(), latenciesMs.end());
+  double p50 = latenciesMs[latenciesMs.size() / 2];
+  double p99 = latenciesMs[latenciesMs.size() * 99 / 100];
+  log_i("AT+CSQ round trip: p50 %.2f ms, p99 %.2f ms, max %.2f ms", p50, p99, latenciesMs.back());
+
+  // 2 ms modem latency plus about 3 ms of 115200 baud transfer for command, echo and reply.
+  EXPECT_GE(latenciesMs.front(), 4.0);
+  EXPECT_LT(p99, 200.0);
+}
+
+FREERTOS_TEST_MAIN()
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "ATRingBuffer/ATRingBuffer.h"
+#include "AsyncATHandler.h"
+#include "Stream.h"
+#include "allocation_counter.h"
+#include "common.h"
+#include "esp_log.h"
+
+#if !AT_STATIC_ALLOCATION
+#error "test_static_allocation must be built against the AT_STATIC_ALLOCATION library"
+#endif
+
+// Answers each command from inside write(): the echo, a +CSQ line for AT+CSQ and OK. Replies
+// go through a ring buffer, so the exchange needs no extra thread and no allocations.
+class AutoReplyStream : public Stream {
+ private:
+  ATRingBuffer<1024> rx;
+  char command[64];
+  size_t commandLength = 0;
+
+  void reply(const char* text) { rx.write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+
+ public:
+  int available() override { return static_cast<int>(rx.available()); }
+  int read() override { return rx.pop(); }
+  int peek() override { return rx.peek(); }
+  void flush() override {}
+
+  size_t write(uint8_t c) override {
+    if (c == '\n' && commandLength && command[commandLength - 1] == '\r') {
+      command[commandLength - 1] = '\0';
+      reply(command);
+      reply("\r\n");
+      if (strcmp(command, "AT+CSQ") == 0) { reply("+CSQ: 20,99\r\n"); }
+      reply("OK\r\n");
+      commandLength = 0;
+    } else if (commandLength < sizeof(command) - 1) {
+      command[commandLength++] = static_cast<char>(c);
+    }
+    return 1;
+  }
+
+  size_t write(const uint8_t* buffer, size_t size) override {
+    for (size_t i = 0; i < size; i++) { write(buffer[i]); }
+    return size;
+  }
+};
+
+class StaticAllocationTest : public FreeRTOSTest {};
+
+TEST_F(StaticAllocationTest, CommandsDoNotAllocateAfterBegin) {
+  static const int kBatches = 250;
+  static const size_t kBatchSize = DefaultATHandlerConfig::MaxPendingCommands;
+
+  AutoReplyStream stream;
+  AsyncATHandler handler;
+  size_t completed = 0;
+  bool testResult = runInFreeRTOSTask(
+      [&]() {
+        if (!handler.begin(stream)) { throw std::runtime_error("Handler begin failed"); }
+        if (!handler.sendSync("AT", 1000)) { throw std::runtime_error("Warm-up failed"); }
+
+        g_allocations = 0;
+        g_countAllocations = true;
+        for (int batch = 0; batch < kBatches; batch++) {
+          ATPromise* promises[kBatchSize];
+          for (auto& promise : promises) { promise = handler.sendCommand("AT+CSQ"); }
+          for (ATPromise* promise : promises) {
+            if (!promise || !promise->timeout(1000)->wait()) { continue; }
+            int rssi = 0, ber = 0;
+            if (promise->getResponse()->scan("+CSQ:", rssi, ber) == 2 && rssi == 20) {
+              completed++;
+            }
+            handler.popCompletedPromise(promise->getId());
+          }
+        }
+        if (!handler.sendSync("AT", 1000)) { throw std::runtime_error("sendSync failed"); }
+        g_countAllocations = false;
+        handler.end();
+      },
+      "StaticAllocationTest", configMINIMAL_STACK_SIZE * 8, 2, 60000);
+  g_countAllocations = false;
+
+  ASSERT_TRUE(testResult);
+  EXPECT_EQ(completed, kBatches * kBatchSize);
+  EXPECT_EQ(g_allocations.load(), 0u);
+}
+
+TEST_F(StaticAllocationTest, ResponseKeepsFinalResultWhenFull) {
+  ATResponse response(1);
+  ResponseLine line;
+  line.type = ResponseType::INTERMEDIATE_DATA;
+  line.commandId = 1;
+  line.timestamp = 0;
+  for (int i = 0; i < AT_STATIC_RESPONSE_LINES + 3; i++) {
+    line.content = "+QLTS: \"2024/01/01,00:00:00+00,0\"\r\n";
+    response.addLine(line);
+  }
+  line.content = "OK\r\n";
+  line.type = ResponseType::FINAL_OK;
+  response.addLine(line);
+
+  EXPECT_EQ(response.getLineCount(), static_cast<size_t>(AT_STATIC_RESPONSE_LINES));
+  EXPECT_TRUE(response.isCompleted());
+  EXPECT_TRUE(response.isSuccess());
+  EXPECT_NE(response.getFullResponse().find("OK\r\n"), std::string::npos);
+}
+
+TEST_F(StaticAllocationTest, InlineStringsTruncate) {
+  ATInlineString<8> text("+QIURC: \"recv\",0");
+  EXPECT_EQ(text.length(), 8u);
+  EXPECT_TRUE(text == "+QIURC: ");
+  EXPECT_EQ(text.indexOf("URC"), 3);
+  EXPECT_TRUE(text.startsWith("+QI"));
+}
+
+FREERTOS_TEST_MAIN()
@@ -0,0 +1,115 @@
+// Decodes trace dumps written by ATTrace::dump() into readable text.
+//
+//   at_trace_decode capture.log
+//   pio device monitor | at_trace_decode
+//
+// Lines outside the ATTRACE ... ATTRACE END block are ignored, so a raw serial capture can be
+// passed as-is.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "ATTrace/ATTrace.settings.h"
+
+// Mirrors the order of ResponseType in ATResponse.settings.h.
+static const char* const kResponseTypes[] = {
+    "FINAL_OK", "FINAL_ERROR", "FINAL_CME_ERROR", "INTERMEDIATE_DATA", "UNSOLICITED"};
+
+static std::string describe(const ATTraceEvent& event) {
+  char text[64];
+  switch (static_cast<ATTraceEventType>(event.type)) {
+    case ATTraceEventType::COMMAND_SENT:
+      snprintf(text, sizeof(text), "id=%" PRIu32 " length=%u", event.id, event.length);
+      break;
+    case ATTraceEventType::LINE_FRAMED:
+    case ATTraceEventType::LINE_OVERFLOW:
+    case ATTraceEventType::URC_DISPATCHED:
+      snprintf(text, sizeof(text), "length=%u", event.length);
+      break;
+    case ATTraceEventType::LINE_CLASSIFIED:
+      snprintf(
+          text, sizeof(text), "%s",
+          event.detail < sizeof(kResponseTypes) / sizeof(kResponseTypes[0])
+              ? kResponseTypes[event.detail]
+              : "?");
+      break;
+    case ATTraceEventType::LINE_ROUTED:
+    case ATTraceEventType::PROMISE_TIMEOUT:
+      snprintf(text, sizeof(text), "promise=%" PRIu32, event.id);
+      break;
+    case ATTraceEventType::PROMISE_SETTLED:
+      snprintf(
+          text, sizeof(text), "promise=%" PRIu32 " %s", event.id, event.detail ? "ok" : "error");
+      break;
+    default:
+      text[0] = '\0';
+      break;
+  }
+  return text;
+}
+
+int main(int argc, char** argv) {
+  FILE* input = argc > 1 ? fopen(argv[1], "r") : stdin;
+  if (!input) {
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  char line[256];
+  bool inDump = false;
+  uint32_t firstTimestamp = 0, previousTimestamp = 0, expectedSequence = 0;
+  size_t events = 0;
+  const size_t magicLength = strlen(AT_TRACE_DUMP_MAGIC);
+
+  while (fgets(line, sizeof(line), input)) {
+    const char* start = strstr(line, AT_TRACE_DUMP_MAGIC);
+    if (start) {
+      if (strncmp(start + magicLength, " END", 4) == 0) {
+        inDump = false;
+        continue;
+      }
+      int version = 0;
+      unsigned count = 0;
+      if (sscanf(start + magicLength, "%d %u", &version, &count) == 2) {
+        if (version != AT_TRACE_DUMP_VERSION) {
+          fprintf(stderr, "Unsupported trace version %d\n", version);
+          return 1;
+        }
+        printf("Trace with %u events\n", count);
+        printf("%8s %12s %10s  %-16s %s\n", "seq", "time_ms", "delta_us", "event", "details");
+        inDump = true;
+        expectedSequence = 0;
+      }
+      continue;
+    }
+    if (!inDump) { continue; }
+
+    unsigned sequence, timestamp, id, length, type, detail;
+    if (sscanf(line, "%x %x %x %x %x %x", &sequence, &timestamp, &id, &length, &type, &detail) !=
+        6) {
+      continue;
+    }
+    ATTraceEvent event = {sequence, timestamp, id, static_cast<uint16_t>(length),
+                          static_cast<uint8_t>(type), static_cast<uint8_t>(detail)};
+
+    if (expectedSequence == 0) {
+      firstTimestamp = previousTimestamp = event.timestampUs;
+    } else if (event.sequence != expectedSequence) {
+      printf("%8s (%u events lost)\n", "...", event.sequence - expectedSequence);
+    }
+    expectedSequence = event.sequence + 1;
+
+    printf(
+        "%8" PRIu32 " %12.3f %+10" PRId32 "  %-16s %s\n", event.sequence,
+        (event.timestampUs - firstTimestamp) / 1000.0,
+        static_cast<int32_t>(event.timestampUs - previousTimestamp), atTraceEventName(event.type),
+        describe(event).c_str());
+    previousTimestamp = event.timestampUs;
+    events++;
+  }
+
+  if (input != stdin) { fclose(input); }
+  return events ? 0 : 1;
+}